@@ -33,10 +33,13 @@ class MyLaunchDescriptionEntity(LaunchDescriptionEntity):
             )
         )
 
+        # The fused executor is built by rmcs_core with RMCS_FUSED_CONFIG for one configuration.
+        fused = LaunchConfiguration("fused", default="false").perform(context) == "true"
+
         entities.append(
             Node(
-                package="rmcs_executor",
-                executable="rmcs_executor",
+                package="rmcs_core" if fused else "rmcs_executor",
+                executable="rmcs_executor_fused" if fused else "rmcs_executor",
                 parameters=[
                     os.path.join(
                         FindPackageShare("rmcs_bringup").perform(context),
@@ -45,7 +48,7 @@ class MyLaunchDescriptionEntity(LaunchDescriptionEntity):
                     ),
                 ],
                 respawn=True,
-                respawn_delay=1.0,
+                respawn_delay=0.2,
                 output="screen",
             )
         )
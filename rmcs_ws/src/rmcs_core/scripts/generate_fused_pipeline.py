@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Generates a fused executor for a frozen robot configuration.
+
+The components of rmcs_core listed in the configuration are compiled into the same translation unit
+as the updating loop, which calls their update() directly in the order the executor resolved for
+that configuration, so that the compiler can inline across components. Components from other
+packages, and partner components, are still loaded as plugins and updated through virtual calls.
+
+The updating order is written by the plugin-based executor when run with the same configuration
+and the parameter `updating_order_path`:
+
+    ros2 run rmcs_executor rmcs_executor --ros-args --params-file infantry_b.yaml \\
+        -p updating_order_path:=infantry_b.order
+"""
+
+import argparse
+import pathlib
+import re
+import sys
+
+import yaml
+
+EXPORT_REGEX = re.compile(r"PLUGINLIB_EXPORT_CLASS\(\s*([\w:]+)\s*,")
+DESCRIPTION_REGEX = re.compile(r"^\s*(\S+)\s*->\s*(\S+)\s*$")
+
+
+def read_components(config_path):
+    with open(config_path) as file:
+        config = yaml.safe_load(file)
+    components = {}
+    for description in config["rmcs_executor"]["ros__parameters"]["components"]:
+        match = DESCRIPTION_REGEX.match(description)
+        plugin_name, component_name = match.groups() if match else (description, description)
+        components[component_name] = plugin_name
+    return components
+
+
+def find_sources(source_dir):
+    sources = {}
+    for path in sorted(pathlib.Path(source_dir).rglob("*.cpp")):
+        for class_name in EXPORT_REGEX.findall(path.read_text()):
+            sources[class_name] = path.resolve()
+    return sources
+
+
+def generate(config_path, order_path, components, sources, updating_order, timed):
+    fused_classes = sorted({plugin for plugin in components.values() if plugin in sources})
+
+    lines = [
+        f"// Generated by generate_fused_pipeline.py from {pathlib.Path(config_path).name} and",
+        f"// {pathlib.Path(order_path).name}. Do not edit.",
+        "",
+        "#include <pluginlib/class_list_macros.hpp>",
+        "",
+        "// The components compiled in are constructed directly instead of being exported.",
+        "#undef PLUGINLIB_EXPORT_CLASS",
+        "#define PLUGINLIB_EXPORT_CLASS(class_type, base_class_type)",
+        "",
+    ]
+    lines += sorted({f'#include "{sources[plugin]}"' for plugin in fused_classes})
+    lines += [
+        "",
+        "#include <rmcs_executor/executor/launcher.hpp>",
+        "",
+        "namespace {",
+        "",
+        "void update(rmcs_executor::UpdateEntry* entries, size_t tick) {",
+    ]
+
+    # Untimed updates skip the latency histogram, the budget and the trace of every component.
+    call = "update" if timed else "update<false>"
+    types = []
+    for index, component_name in enumerate(updating_order):
+        plugin_name = components.get(component_name)
+        if plugin_name in fused_classes:
+            lines += [
+                f"    // {component_name}",
+                f"    entries[{index}].{call}(tick, [component = entries[{index}].component]() {{",
+                f"        static_cast<{plugin_name}*>(component)->{plugin_name}::update();",
+                "    });",
+            ]
+            types.append(f"&typeid({plugin_name})")
+        else:
+            lines.append(f"    entries[{index}].{call}(tick); // {component_name}")
+            types.append("nullptr")
+    lines += ["}", ""]
+
+    lines += [
+        "std::shared_ptr<rmcs_executor::Component> construct(const std::string& plugin_name) {",
+    ]
+    for plugin_name in fused_classes:
+        lines += [
+            f'    if (plugin_name == "{plugin_name}")',
+            f"        return std::make_shared<{plugin_name}>();",
+        ]
+    lines += ["    return nullptr;", "}", "", "} // namespace", ""]
+
+    lines += [
+        "int main(int argc, char** argv) {",
+        "    return rmcs_executor::run(",
+        "        argc, argv, construct,",
+        "        rmcs_executor::FusedPipeline{",
+        "            .updating_order = {",
+    ]
+    lines += [f'                "{component_name}",' for component_name in updating_order]
+    lines += ["            },", "            .types = {"]
+    lines += [f"                {type_pointer}," for type_pointer in types]
+    lines += ["            },", "            .update = update,"]
+    lines += [f"            .timed = {'true' if timed else 'false'},", "        });", "}", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--config", required=True, help="robot configuration (yaml)")
+    parser.add_argument("--order", required=True, help="updating order written by the executor")
+    parser.add_argument("--sources", required=True, help="source directory of rmcs_core")
+    parser.add_argument("--output", required=True, help="generated source file")
+    parser.add_argument(
+        "--untimed", action="store_true", help="do not measure the updates of the components"
+    )
+    args = parser.parse_args()
+
+    components = read_components(args.config)
+    sources = find_sources(args.sources)
+    with open(args.order) as file:
+        updating_order = [line.strip() for line in file if line.strip()]
+
+    missing = [name for name in components if name not in updating_order]
+    if missing:
+        sys.exit(
+            f"{args.order} does not match {args.config}, missing: {', '.join(missing)}. "
+            "Write the updating order again with the current configuration."
+        )
+
+    source = generate(
+        args.config, args.order, components, sources, updating_order, not args.untimed
+    )
+    output = pathlib.Path(args.output)
+    if not output.exists() or output.read_text() != source:
+        output.write_text(source)
+
+
+if __name__ == "__main__":
+    main()
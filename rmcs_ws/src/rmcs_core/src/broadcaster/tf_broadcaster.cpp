@@ -19,28 +19,16 @@ public:
         : Node{
               get_component_name(),
               rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)} {
-        register_input("/predefined/timestamp", timestamp_);
-        register_input("/predefined/update_count", update_count_);
+        using namespace std::chrono_literals;
+        set_update_period(50ms);
 
         register_input("/tf", tf_);
     }
     ~TfBroadcaster() = default;
 
-    void update() override {
-        using namespace std::chrono_literals;
-        if (*update_count_ == 0)
-            next_publish_timestamp_ = *timestamp_;
-        if (*timestamp_ >= next_publish_timestamp_) {
-            fast_tf::rcl::broadcast_all(*tf_);
-            next_publish_timestamp_ += 50ms;
-        }
-    }
+    void update() override { fast_tf::rcl::broadcast_all(*tf_); }
 
 private:
-    InputInterface<size_t> update_count_;
-    InputInterface<std::chrono::steady_clock::time_point> timestamp_;
-    std::chrono::steady_clock::time_point next_publish_timestamp_;
-
     InputInterface<rmcs_description::Tf> tf_;
 };
 
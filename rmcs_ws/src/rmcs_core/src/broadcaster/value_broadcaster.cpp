@@ -1,6 +1,9 @@
+#include <set>
+
 #include <rclcpp/node.hpp>
 #include <rclcpp/parameter_event_handler.hpp>
 #include <rmcs_executor/component.hpp>
+#include <rmcs_executor/mailbox.hpp>
 #include <std_msgs/msg/float64.hpp>
 #include <std_msgs/msg/header.hpp>
 
@@ -10,6 +13,10 @@ class ValueBroadcaster
     : public rmcs_executor::Component
     , public rclcpp::Node {
 public:
+    // Read through the node, whose parameters may change at runtime.
+    using rclcpp::Node::get_logger;
+    using rclcpp::Node::get_parameter;
+
     ValueBroadcaster()
         : Node{
               get_component_name(),
@@ -20,6 +27,15 @@ public:
             [this](const rclcpp::Parameter& para) { update_forward_list(para.as_string_array()); });
 
         declare_parameter<std::vector<std::string>>("forward_list", std::vector<std::string>{});
+
+        // Values are queued by update() and published from the ROS spin thread, which keeps
+        // serialization and DDS off the control thread.
+        double publish_period = 0.01;
+        get_parameter("publish_period", publish_period);
+        publish_timer_ = create_wall_timer(std::chrono::duration<double>(publish_period), [this]() {
+            for (auto& [name, unit] : forward_units_)
+                unit->publish();
+        });
     }
 
     void before_pairing(
@@ -42,30 +58,33 @@ public:
     }
 
 private:
+    // Publishers are managed on the spin thread, while the control thread only learns at its next
+    // update which values to queue.
     void update_forward_list(const std::vector<std::string>& forward_list) {
-        for (auto& [name, unit] : forward_units_)
-            unit->active = false;
-
+        auto active_names = std::set<std::string>{};
         for (auto& name : forward_list) {
-            auto iter = forward_units_.find(name);
-            if (iter == forward_units_.end()) {
+            if (!forward_units_.contains(name)) {
                 RCLCPP_ERROR(
                     get_logger(),
                     "Unable to find corresponding output of '%s', maybe the type of output is "
                     "unsupported or the output does not exist.",
                     name.c_str());
             } else {
-                auto& unit   = iter->second;
-                unit->active = true;
+                active_names.emplace(name);
             }
         }
 
         for (auto& [name, unit] : forward_units_) {
-            if (unit->active)
+            if (active_names.contains(name))
                 unit->activate(this);
             else
                 unit->deactivate();
         }
+
+        defer([this, active_names = std::move(active_names)]() {
+            for (auto& [name, unit] : forward_units_)
+                unit->active = active_names.contains(name);
+        });
     }
 
     class BasicForwarderUnit {
@@ -74,9 +93,10 @@ private:
 
         virtual void activate(rclcpp::Node* node) = 0;
         virtual void update()                     = 0;
+        virtual void publish()                    = 0;
         virtual void deactivate()                 = 0;
 
-        bool active;
+        bool active = false;
     };
 
     template <typename StdT, typename RosT>
@@ -94,13 +114,20 @@ private:
                 publisher_ = node->create_publisher<RosT>(name_, rclcpp::QoS{5}.reliable());
         }
 
+        // Values are dropped while the queue is full, i.e. if the spin thread falls far behind.
         void update() override {
-            if (!publisher_)
-                return;
+            if (active)
+                queue_.write(*input_);
+        }
 
-            RosT msg;
-            msg.data = *input_;
-            publisher_->publish(msg);
+        void publish() override {
+            while (auto value = queue_.read()) {
+                if (!publisher_)
+                    continue;
+                RosT msg;
+                msg.data = *value;
+                publisher_->publish(msg);
+            }
         }
 
         void deactivate() override { publisher_ = nullptr; }
@@ -108,6 +135,7 @@ private:
     private:
         std::string name_;
         InputInterface<StdT> input_;
+        rmcs_executor::mailbox::SpscQueue<StdT, 256> queue_;
         rclcpp::Publisher<RosT>::SharedPtr publisher_;
     };
 
@@ -115,6 +143,7 @@ private:
 
     std::unique_ptr<rclcpp::ParameterEventHandler> parameter_subscriber_;
     std::shared_ptr<rclcpp::ParameterCallbackHandle> parameter_callback_;
+    rclcpp::TimerBase::SharedPtr publish_timer_;
 };
 
 } // namespace rmcs_core::broadcaster
@@ -1,5 +1,4 @@
 #include <eigen3/Eigen/Dense>
-#include <rclcpp/node.hpp>
 #include <rmcs_description/tf_description.hpp>
 #include <rmcs_executor/component.hpp>
 #include <rmcs_msgs/chassis_mode.hpp>
@@ -11,15 +10,10 @@
 
 namespace rmcs_core::controller::chassis {
 
-class ChassisController
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class ChassisController : public rmcs_executor::Component {
 public:
     ChassisController()
-        : Node(
-              get_component_name(),
-              rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true))
-        , following_velocity_controller_(7.0, 0.0, 0.0) {
+        : following_velocity_controller_(7.0, 0.0, 0.0) {
         following_velocity_controller_.output_max = angular_velocity_max;
         following_velocity_controller_.output_min = -angular_velocity_max;
 
@@ -6,7 +6,6 @@
 #include <numbers>
 
 #include <eigen3/Eigen/Dense>
-#include <rclcpp/node.hpp>
 #include <rmcs_description/tf_description.hpp>
 #include <rmcs_executor/component.hpp>
 #include <rmcs_msgs/chassis_mode.hpp>
@@ -16,15 +15,10 @@
 
 namespace rmcs_core::controller::chassis {
 
-class OmniWheelController
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class OmniWheelController : public rmcs_executor::Component {
 public:
     OmniWheelController()
-        : Node(
-              get_component_name(),
-              rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true))
-        , translational_velocity_pid_calculator_(100.0, 0.0, 0.0)
+        : translational_velocity_pid_calculator_(100.0, 0.0, 0.0)
         , angular_velocity_pid_calculator_(100.0, 0.0, 0.0) {
 
         register_input("/chassis/left_front_wheel/max_torque", wheel_motor_max_control_torque_);
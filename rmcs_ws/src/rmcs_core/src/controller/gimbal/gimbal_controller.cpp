@@ -4,7 +4,6 @@
 
 #include <eigen3/Eigen/Dense>
 #include <fast_tf/rcl.hpp>
-#include <rclcpp/node.hpp>
 #include <rmcs_description/tf_description.hpp>
 #include <rmcs_executor/component.hpp>
 #include <rmcs_msgs/mouse.hpp>
@@ -15,14 +14,9 @@ namespace rmcs_core::controller::gimbal {
 
 using namespace rmcs_description;
 
-class GimbalController
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class GimbalController : public rmcs_executor::Component {
 public:
-    GimbalController()
-        : Node(
-              get_component_name(),
-              rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)) {
+    GimbalController() {
         upper_limit_ = get_parameter("upper_limit").as_double() + (std::numbers::pi / 2);
         lower_limit_ = get_parameter("lower_limit").as_double() + (std::numbers::pi / 2);
 
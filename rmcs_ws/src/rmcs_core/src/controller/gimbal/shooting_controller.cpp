@@ -4,7 +4,6 @@
 
 #include <eigen3/Eigen/Dense>
 #include <fast_tf/rcl.hpp>
-#include <rclcpp/node.hpp>
 #include <rmcs_description/tf_description.hpp>
 #include <rmcs_executor/component.hpp>
 #include <rmcs_msgs/keyboard.hpp>
@@ -15,15 +14,10 @@
 
 namespace rmcs_core::controller::gimbal {
 
-class ShootingController
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class ShootingController : public rmcs_executor::Component {
 public:
     ShootingController()
-        : Node(
-              get_component_name(),
-              rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true))
-        , logger_(get_logger()) {
+        : logger_(get_logger()) {
 
         register_input("/remote/switch/right", switch_right_);
         register_input("/remote/switch/left", switch_left_);
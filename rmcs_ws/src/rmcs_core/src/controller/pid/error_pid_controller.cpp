@@ -1,5 +1,4 @@
 #include <rclcpp/logging.hpp>
-#include <rclcpp/node.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <rmcs_executor/component.hpp>
 
@@ -7,15 +6,10 @@
 
 namespace rmcs_core::controller::pid {
 
-class ErrorPidController
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class ErrorPidController : public rmcs_executor::Component {
 public:
     ErrorPidController()
-        : Node(
-              get_component_name(),
-              rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true))
-        , pid_calculator_(
+        : pid_calculator_(
               get_parameter("kp").as_double(), get_parameter("ki").as_double(),
               get_parameter("kd").as_double()) {
 
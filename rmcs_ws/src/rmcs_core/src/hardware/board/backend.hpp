@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rmcs_core::hardware::board {
+
+// What a board reports, called from the thread running Backend::run(). Mirrors the receive
+// callbacks of librmcs::client::CBoard.
+class Callbacks {
+public:
+    virtual ~Callbacks() = default;
+
+    virtual void can1_receive_callback(
+        uint32_t can_id, uint64_t can_data, bool is_extended_can_id, bool is_remote_transmission,
+        uint8_t can_data_length) = 0;
+    virtual void can2_receive_callback(
+        uint32_t can_id, uint64_t can_data, bool is_extended_can_id, bool is_remote_transmission,
+        uint8_t can_data_length) = 0;
+    virtual void uart1_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) = 0;
+    virtual void dbus_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) = 0;
+    virtual void accelerometer_receive_callback(int16_t x, int16_t y, int16_t z) = 0;
+    virtual void gyroscope_receive_callback(int16_t x, int16_t y, int16_t z) = 0;
+};
+
+// A board, either connected through USB or simulated in-process. Transmissions are added and
+// triggered by one thread at a time, like a librmcs::client::CBoard::TransmitBuffer.
+class Backend {
+public:
+    virtual ~Backend() = default;
+
+    virtual void add_can_transmission(int bus, uint32_t can_id, uint64_t can_data) = 0;
+    virtual void add_uart1_transmission(const std::byte* uart_data, size_t uart_data_length) = 0;
+    virtual void trigger_transmission() = 0;
+
+    // Blocks, calling back on the calling thread, until stop() is called from another one.
+    virtual void run()  = 0;
+    virtual void stop() = 0;
+};
+
+} // namespace rmcs_core::hardware::board
\ No newline at end of file
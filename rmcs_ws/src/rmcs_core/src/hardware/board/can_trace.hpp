@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rmcs_core::hardware::board {
+
+// Standard CAN frames received by a board, one per line, e.g.
+//
+//   0.001024 1 0x201 0x00000000D2043C1F
+//
+// with the time in seconds since the first frame, the bus, the identifier and the data as the
+// 64-bit value passed to the receive callbacks.
+struct CanTraceFrame {
+    double time;
+    int bus;
+    uint32_t can_id;
+    uint64_t can_data;
+};
+
+class CanTraceWriter {
+public:
+    explicit CanTraceWriter(const std::string& path)
+        : file_(std::fopen(path.c_str(), "w")) {
+        if (!file_)
+            throw std::runtime_error{"Unable to open CAN trace " + path};
+    }
+
+    // Called from the event thread of the board. Writes are buffered by stdio.
+    void write(int bus, uint32_t can_id, uint64_t can_data) {
+        auto now = std::chrono::steady_clock::now();
+        if (begin_ == std::chrono::steady_clock::time_point{})
+            begin_ = now;
+        std::fprintf(
+            file_.get(), "%.6f %d 0x%03" PRIX32 " 0x%016" PRIX64 "\n",
+            std::chrono::duration<double>(now - begin_).count(), bus, can_id, can_data);
+    }
+
+private:
+    struct FileCloser {
+        void operator()(std::FILE* file) const { std::fclose(file); }
+    };
+    std::unique_ptr<std::FILE, FileCloser> file_;
+    std::chrono::steady_clock::time_point begin_{};
+};
+
+inline std::vector<CanTraceFrame> read_can_trace(const std::string& path) {
+    auto file = std::unique_ptr<std::FILE, int (*)(std::FILE*)>{
+        std::fopen(path.c_str(), "r"), &std::fclose};
+    if (!file)
+        throw std::runtime_error{"Unable to open CAN trace " + path};
+
+    std::vector<CanTraceFrame> frames;
+    CanTraceFrame frame;
+    while (std::fscanf(
+               file.get(), "%lf %d %" SCNx32 " %" SCNx64, &frame.time, &frame.bus,
+               &frame.can_id, &frame.can_data)
+           == 4)
+        frames.push_back(frame);
+    if (!std::feof(file.get()))
+        throw std::runtime_error{"Malformed CAN trace " + path};
+    return frames;
+}
+
+} // namespace rmcs_core::hardware::board
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <librmcs/client/cboard.hpp>
+
+#include "hardware/board/backend.hpp"
+#include "hardware/board/can_trace.hpp"
+
+namespace rmcs_core::hardware::board {
+
+// A CBoard connected through USB, optionally recording the CAN frames it receives into a trace
+// to be replayed by a VirtualBackend.
+class UsbBackend final
+    : public Backend
+    , private librmcs::client::CBoard {
+public:
+    UsbBackend(Callbacks& callbacks, int usb_pid, const std::string& can_record_path = "")
+        : librmcs::client::CBoard{usb_pid}
+        , callbacks_(callbacks)
+        , transmit_buffer_(*this, 32) {
+        if (!can_record_path.empty())
+            can_trace_writer_.emplace(can_record_path);
+    }
+
+    void add_can_transmission(int bus, uint32_t can_id, uint64_t can_data) override {
+        if (bus == 1)
+            transmit_buffer_.add_can1_transmission(can_id, can_data);
+        else
+            transmit_buffer_.add_can2_transmission(can_id, can_data);
+    }
+
+    void add_uart1_transmission(const std::byte* uart_data, size_t uart_data_length) override {
+        transmit_buffer_.add_uart1_transmission(uart_data, uart_data_length);
+    }
+
+    void trigger_transmission() override { transmit_buffer_.trigger_transmission(); }
+
+    void run() override { handle_events(); }
+    void stop() override { stop_handling_events(); }
+
+private:
+    void can1_receive_callback(
+        uint32_t can_id, uint64_t can_data, bool is_extended_can_id, bool is_remote_transmission,
+        uint8_t can_data_length) override {
+        if (can_trace_writer_ && !is_extended_can_id && !is_remote_transmission)
+            can_trace_writer_->write(1, can_id, can_data);
+        callbacks_.can1_receive_callback(
+            can_id, can_data, is_extended_can_id, is_remote_transmission, can_data_length);
+    }
+
+    void can2_receive_callback(
+        uint32_t can_id, uint64_t can_data, bool is_extended_can_id, bool is_remote_transmission,
+        uint8_t can_data_length) override {
+        if (can_trace_writer_ && !is_extended_can_id && !is_remote_transmission)
+            can_trace_writer_->write(2, can_id, can_data);
+        callbacks_.can2_receive_callback(
+            can_id, can_data, is_extended_can_id, is_remote_transmission, can_data_length);
+    }
+
+    void uart1_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) override {
+        callbacks_.uart1_receive_callback(uart_data, uart_data_length);
+    }
+
+    void dbus_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) override {
+        callbacks_.dbus_receive_callback(uart_data, uart_data_length);
+    }
+
+    void accelerometer_receive_callback(int16_t x, int16_t y, int16_t z) override {
+        callbacks_.accelerometer_receive_callback(x, y, z);
+    }
+
+    void gyroscope_receive_callback(int16_t x, int16_t y, int16_t z) override {
+        callbacks_.gyroscope_receive_callback(x, y, z);
+    }
+
+    Callbacks& callbacks_;
+    librmcs::client::CBoard::TransmitBuffer transmit_buffer_;
+    std::optional<CanTraceWriter> can_trace_writer_;
+};
+
+} // namespace rmcs_core::hardware::board
\ No newline at end of file
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hardware/board/backend.hpp"
+#include "hardware/board/can_trace.hpp"
+
+namespace rmcs_core::hardware::board {
+
+// A board simulated in-process, to run the hardware and everything downstream of it without a
+// robot. Every period, it calls back with the feedback of its simulated devices (or the frames of
+// a recorded CAN trace), a still IMU and a remote in its neutral position. Commands transmitted to
+// it drive the simulated motors, through a crude first-order model of their velocity.
+//
+// By default, run() paces the board on the steady clock. A stepped board is instead advanced by
+// step() from the hardware update, up to the timestamp of the tick, so that it follows the
+// executor under a simulated clock: every tick then sees the feedback of exactly one period.
+class VirtualBackend final : public Backend {
+public:
+    struct Config {
+        // Feedback frames of every device per second, e.g. 8000 for the load of a full bus.
+        double rate = 1000.0;
+        // Replayed instead of simulating the devices when not empty.
+        std::string can_trace_path;
+        // Advanced by step() instead of run().
+        bool stepped = false;
+    };
+
+    // Frames passed to the callbacks, and frames added for transmission, with the time spent.
+    struct Statistics {
+        uint64_t received_frames, receive_time_ns;
+        uint64_t transmitted_frames, transmit_time_ns;
+    };
+
+    VirtualBackend(Callbacks& callbacks, const Config& config)
+        : callbacks_(callbacks)
+        , config_(config) {
+        if (!(config_.rate > 0))
+            throw std::invalid_argument{"Rate of a virtual board must be positive"};
+        period_ = std::chrono::nanoseconds{
+            static_cast<long>(std::round(1'000'000'000.0 / config_.rate))};
+        if (!config_.can_trace_path.empty())
+            can_trace_ = read_can_trace(config_.can_trace_path);
+    }
+
+    // Simulated devices are added before run(). DJI motors take a 16-bit slot of a shared command
+    // frame, LK motors a velocity command frame of their own.
+    void add_dji_motor(int bus, uint32_t feedback_id, uint32_t command_id, size_t slot) {
+        motors_.emplace_back(Motor::Kind::DJI, bus, feedback_id, command_id, slot);
+    }
+    void add_lk_motor(int bus, uint32_t can_id) {
+        motors_.emplace_back(Motor::Kind::LK, bus, can_id, can_id, 0);
+    }
+    void add_supercap(int bus, uint32_t can_id) { supercaps_.push_back({bus, can_id}); }
+
+    void add_can_transmission(int bus, uint32_t can_id, uint64_t can_data) override {
+        auto begin = std::chrono::steady_clock::now();
+        for (auto& motor : motors_) {
+            if (motor.bus != bus || motor.command_id != can_id)
+                continue;
+            if (motor.kind == Motor::Kind::DJI) {
+                // Slots are big-endian 16-bit currents.
+                auto value = static_cast<uint16_t>(can_data >> (16 * motor.slot));
+                motor.command.store(
+                    static_cast<int16_t>(std::rotl(value, 8)), std::memory_order::relaxed);
+            } else if (static_cast<uint8_t>(can_data) == 0xA2) {
+                // Little-endian 32-bit velocity in 0.01 dps.
+                motor.command.store(
+                    static_cast<int32_t>(can_data >> 32), std::memory_order::relaxed);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        add(transmitted_frames_, 1);
+        add(transmit_time_ns_, std::chrono::nanoseconds{end - begin}.count());
+    }
+
+    void add_uart1_transmission(const std::byte*, size_t) override {}
+
+    void trigger_transmission() override {}
+
+    // A stepped board has nothing to do here but wait.
+    void run() override {
+        if (config_.stepped) {
+            stopping_.wait(false, std::memory_order::relaxed);
+            return;
+        }
+        while (!stopping_.load(std::memory_order::relaxed)) {
+            step(std::chrono::steady_clock::now());
+            std::this_thread::sleep_until(next_iteration_time_);
+        }
+    }
+
+    void stop() override {
+        stopping_.store(true, std::memory_order::relaxed);
+        stopping_.notify_all();
+    }
+
+    bool stepped() const { return config_.stepped; }
+
+    // Simulates every period up to `now`, calling back on the calling thread. The first call only
+    // simulates a single period.
+    void step(std::chrono::steady_clock::time_point now) {
+        if (!started_) {
+            begin_   = next_iteration_time_ = next_dbus_time_ = now;
+            started_ = true;
+        }
+        for (; next_iteration_time_ <= now; next_iteration_time_ += period_)
+            simulate_period(next_iteration_time_);
+    }
+
+    Statistics statistics() const {
+        return {
+            received_frames_.load(std::memory_order::relaxed),
+            receive_time_ns_.load(std::memory_order::relaxed),
+            transmitted_frames_.load(std::memory_order::relaxed),
+            transmit_time_ns_.load(std::memory_order::relaxed)};
+    }
+
+private:
+    struct Motor {
+        enum class Kind { DJI, LK } kind;
+        int bus;
+        uint32_t feedback_id, command_id;
+        size_t slot;
+
+        // Written by the thread transmitting commands.
+        std::atomic<int32_t> command = 0;
+
+        double angle = 0, velocity = 0;
+
+        Motor(Kind kind, int bus, uint32_t feedback_id, uint32_t command_id, size_t slot)
+            : kind(kind)
+            , bus(bus)
+            , feedback_id(feedback_id)
+            , command_id(command_id)
+            , slot(slot) {}
+
+        // Advances the motor and returns its feedback frame.
+        uint64_t step(double dt) {
+            constexpr double time_constant = 0.1;
+            auto command = this->command.load(std::memory_order::relaxed);
+
+            std::array<uint8_t, 8> data{};
+            if (kind == Kind::DJI) {
+                // Full current spins the rotor up to 50 rad/s.
+                constexpr double max_velocity = 50.0;
+                velocity += (command / 16384.0 * max_velocity - velocity) * dt / time_constant;
+                constexpr double turn = 2 * std::numbers::pi;
+                angle = std::fmod(angle + velocity * dt + turn, turn);
+
+                auto encoder = static_cast<uint16_t>(angle / turn * 8192) % 8192;
+                auto rpm     = static_cast<int16_t>(velocity * 60 / turn);
+                auto current = static_cast<int16_t>(command);
+                data         = {
+                    static_cast<uint8_t>(encoder >> 8), static_cast<uint8_t>(encoder),
+                    static_cast<uint8_t>(rpm >> 8),     static_cast<uint8_t>(rpm),
+                    static_cast<uint8_t>(current >> 8), static_cast<uint8_t>(current),
+                    30,                                 0};
+            } else {
+                // Velocities are in degrees per second.
+                velocity += (command / 100.0 - velocity) * dt / time_constant;
+                angle = std::fmod(angle + velocity * dt + 360.0, 360.0);
+
+                auto encoder = static_cast<uint16_t>(angle / 360.0 * 65536);
+                auto speed   = static_cast<int16_t>(velocity);
+                data         = {
+                    0xA2, 30, 0, 0, static_cast<uint8_t>(speed), static_cast<uint8_t>(speed >> 8),
+                    static_cast<uint8_t>(encoder), static_cast<uint8_t>(encoder >> 8)};
+            }
+            return std::bit_cast<uint64_t>(data);
+        }
+    };
+
+    struct Supercap {
+        int bus;
+        uint32_t can_id;
+    };
+
+    // 24 V on the chassis, 20 V in the capacitors, enabled.
+    static uint64_t supercap_status() {
+        constexpr auto voltage = [](double value) {
+            return static_cast<uint64_t>(value / 50.0 * 65535);
+        };
+        return voltage(20.0) << 16 | voltage(24.0) << 32 | uint64_t{1} << 48;
+    }
+
+    // Sticks centered and both switches down.
+    static std::array<std::byte, 18> neutral_dbus_frame() {
+        constexpr uint64_t center = 1024, down = 2;
+        uint64_t channels = center | center << 11 | center << 22 | center << 33 | down << 44
+                          | down << 46;
+        std::array<std::byte, 18> frame{};
+        std::memcpy(frame.data(), &channels, 6);
+        std::memcpy(frame.data() + 16, &center, 2);
+        return frame;
+    }
+
+    void simulate_period(std::chrono::steady_clock::time_point time) {
+        if (can_trace_.empty()) {
+            const double dt = 1.0 / config_.rate;
+            for (auto& motor : motors_)
+                receive(motor.bus, motor.feedback_id, motor.step(dt));
+            for (auto& supercap : supercaps_)
+                receive(supercap.bus, supercap.can_id, supercap_status());
+        } else {
+            auto elapsed = std::chrono::duration<double>(time - begin_).count();
+            for (; next_trace_frame_ < can_trace_.size()
+                   && can_trace_[next_trace_frame_].time <= elapsed;
+                 next_trace_frame_++) {
+                const auto& frame = can_trace_[next_trace_frame_];
+                receive(frame.bus, frame.can_id, frame.can_data);
+            }
+        }
+
+        // At rest and level, 1 g on the z axis in the ±6 g range.
+        callbacks_.gyroscope_receive_callback(0, 0, 0);
+        callbacks_.accelerometer_receive_callback(0, 0, 5461);
+
+        // The receiver of the remote sends a frame every 14 ms.
+        if (time >= next_dbus_time_) {
+            auto frame = neutral_dbus_frame();
+            callbacks_.dbus_receive_callback(frame.data(), frame.size());
+            next_dbus_time_ += std::chrono::milliseconds(14);
+        }
+    }
+
+    void receive(int bus, uint32_t can_id, uint64_t can_data) {
+        auto begin = std::chrono::steady_clock::now();
+        if (bus == 1)
+            callbacks_.can1_receive_callback(can_id, can_data, false, false, 8);
+        else
+            callbacks_.can2_receive_callback(can_id, can_data, false, false, 8);
+        auto end = std::chrono::steady_clock::now();
+        add(received_frames_, 1);
+        add(receive_time_ns_, std::chrono::nanoseconds{end - begin}.count());
+    }
+
+    // Counters have a single writer each.
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order::relaxed) + value, std::memory_order::relaxed);
+    }
+
+    Callbacks& callbacks_;
+    Config config_;
+    std::chrono::nanoseconds period_;
+
+    // Owned by the thread simulating the board.
+    bool started_ = false;
+    std::chrono::steady_clock::time_point begin_, next_iteration_time_, next_dbus_time_;
+    size_t next_trace_frame_ = 0;
+
+    std::deque<Motor> motors_;
+    std::vector<Supercap> supercaps_;
+    std::vector<CanTraceFrame> can_trace_;
+
+    std::atomic<uint64_t> received_frames_ = 0, receive_time_ns_ = 0;
+    std::atomic<uint64_t> transmitted_frames_ = 0, transmit_time_ns_ = 0;
+
+    std::atomic<bool> stopping_ = false;
+};
+
+} // namespace rmcs_core::hardware::board
\ No newline at end of file
@@ -1,9 +1,75 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include <librmcs/device/bmi088.hpp>
+#include <rmcs_executor/component.hpp>
 
 namespace rmcs_core::hardware::device {
 
-using Bmi088 = librmcs::device::Bmi088;
+class Bmi088 : public librmcs::device::Bmi088 {
+public:
+    using Samples = std::array<rmcs_executor::mailbox::SampleSummary, 3>;
+
+    Bmi088(double sample_rate, double kp, double ki)
+        : librmcs::device::Bmi088(sample_rate, kp, ki)
+        , decoder_(sample_rate, kp, ki) {}
+
+    // Only the IMU of the gimbal publishes its samples, other boards carry one as well.
+    void register_outputs(rmcs_executor::Component& status_component) {
+        status_component.register_output(
+            "/imu/accelerometer_samples", accelerometer_output_, Samples{});
+        status_component.register_output("/imu/gyroscope_samples", gyroscope_output_, Samples{});
+    }
+
+    // Called from the event thread of the board.
+    void store_accelerometer_status(int16_t x, int16_t y, int16_t z) {
+        librmcs::device::Bmi088::store_accelerometer_status(x, y, z);
+        decoder_.store_accelerometer_status(x, y, z);
+        decoder_.update_status();
+        accelerometer_samples_.output().write(
+            Aggregator::Sample{decoder_.ax(), decoder_.ay(), decoder_.az()});
+    }
+
+    // Called from the event thread of the board.
+    void store_gyroscope_status(int16_t x, int16_t y, int16_t z) {
+        librmcs::device::Bmi088::store_gyroscope_status(x, y, z);
+        decoder_.store_gyroscope_status(x, y, z);
+        decoder_.update_status();
+        gyroscope_samples_.output().write(
+            Aggregator::Sample{decoder_.gx(), decoder_.gy(), decoder_.gz()});
+    }
+
+    void update_status() {
+        librmcs::device::Bmi088::update_status();
+        accelerometer_ = accelerometer_samples_.read();
+        gyroscope_     = gyroscope_samples_.read();
+        if (accelerometer_output_.active()) {
+            *accelerometer_output_ = accelerometer_;
+            *gyroscope_output_     = gyroscope_;
+        }
+    }
+
+    // Every sample received until the last update_status(), per axis as librmcs reports them in
+    // ax() ... gz(). The attitude filter of librmcs still only takes the latest one.
+    const Samples& accelerometer_samples() const { return accelerometer_; }
+    const Samples& gyroscope_samples() const { return gyroscope_; }
+
+private:
+    using Aggregator = rmcs_executor::mailbox::Aggregator<3>;
+
+    // Decodes every sample exactly as librmcs reports them. Only used by the event thread.
+    // librmcs applies its ranges and axis mapping inside update_status() and exposes neither, so
+    // each sample costs a full update, attitude filter included, whose attitude is discarded.
+    // Inverting the scaling here instead would silently drift from librmcs if it ever changed.
+    librmcs::device::Bmi088 decoder_;
+
+    rmcs_executor::Component::AsyncInput<Aggregator::Sample, Aggregator> accelerometer_samples_,
+        gyroscope_samples_;
+
+    Samples accelerometer_{}, gyroscope_{};
+    rmcs_executor::Component::OutputInterface<Samples> accelerometer_output_, gyroscope_output_;
+};
 
 } // namespace rmcs_core::hardware::device
\ No newline at end of file
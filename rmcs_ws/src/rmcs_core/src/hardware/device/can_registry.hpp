@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+
+namespace rmcs_core::hardware::device {
+
+// Routes the standard frames received on one CAN bus to the devices registered for their
+// identifier. Dispatching indexes a table over the whole 11-bit identifier space, and unregistered
+// identifiers land on a slot doing nothing, so that every frame takes the same path.
+//
+// Devices are registered before the event thread of the board starts. Every slot counts its
+// frames, which tells devices gone silent (e.g. a motor losing power) apart from a dead bus.
+class CanRegistry {
+public:
+    explicit CanRegistry(std::string bus_name)
+        : bus_name_(std::move(bus_name)) {}
+
+    CanRegistry(const CanRegistry&)            = delete;
+    CanRegistry& operator=(const CanRegistry&) = delete;
+
+    // `Device` must have `store_status(uint64_t)`, called from the event thread of the board.
+    // Devices that may stay silent on this bus, e.g. wired to either of two buses, are only
+    // reported when silent on every bus they are registered on.
+    template <typename Device>
+    void register_device(
+        uint32_t can_id, Device& device, std::string name, bool may_stay_silent = false) {
+        if (can_id >= index_.size())
+            throw std::invalid_argument{"CAN identifier out of the 11-bit range: " + name};
+        if (index_[can_id])
+            throw std::invalid_argument{
+                "CAN identifier registered twice on " + bus_name_ + ": " + name};
+        if (slot_count_ == slots_.size())
+            throw std::length_error{"Too many devices registered on " + bus_name_};
+
+        auto& slot   = slots_[slot_count_];
+        slot.receive = [](void* device, uint64_t can_data) {
+            static_cast<Device*>(device)->store_status(can_data);
+        };
+        slot.device          = &device;
+        slot.can_id          = can_id;
+        slot.name            = std::move(name);
+        slot.may_stay_silent = may_stay_silent;
+        index_[can_id]       = static_cast<uint8_t>(slot_count_++);
+    }
+
+    // Called from the event thread of the board.
+    void dispatch(uint32_t can_id, uint64_t can_data) {
+        auto& slot = slots_[index_[can_id & (index_.size() - 1)]];
+        slot.receive_count.store(
+            slot.receive_count.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+        slot.receive(slot.device, can_data);
+    }
+
+    uint64_t receive_count(uint32_t can_id) const {
+        return slots_[index_[can_id & (index_.size() - 1)]].receive_count.load(
+            std::memory_order::relaxed);
+    }
+    uint64_t unregistered_receive_count() const {
+        return slots_[0].receive_count.load(std::memory_order::relaxed);
+    }
+
+    // Called periodically from one thread, e.g. a timer of the node. Warns about the devices from
+    // which nothing was received since the previous call. Registries sharing devices that may stay
+    // silent on some of them must be reported together.
+    static void report_silent_devices(
+        const rclcpp::Logger& logger, std::initializer_list<CanRegistry*> registries) {
+        for (auto registry : registries) {
+            for (size_t i = 1; i < registry->slot_count_; i++) {
+                auto& slot = registry->slots_[i];
+                if (slot.may_stay_silent)
+                    continue;
+
+                bool silent = update_silence(slot);
+                if (silent && !slot.reported_silent)
+                    RCLCPP_WARN(
+                        logger, "No feedback from %s (0x%03X on %s)", slot.name.c_str(),
+                        slot.can_id, registry->bus_name_.c_str());
+                else if (!silent && slot.reported_silent)
+                    RCLCPP_INFO(
+                        logger, "Feedback from %s (0x%03X on %s) is back", slot.name.c_str(),
+                        slot.can_id, registry->bus_name_.c_str());
+                slot.reported_silent = silent;
+            }
+        }
+
+        // Devices that may stay silent on a bus, grouped by device across the registries.
+        std::vector<const void*> reported_devices;
+        for (auto registry : registries) {
+            for (size_t i = 1; i < registry->slot_count_; i++) {
+                auto& first = registry->slots_[i];
+                if (!first.may_stay_silent
+                    || std::ranges::find(reported_devices, first.device) != reported_devices.end())
+                    continue;
+                reported_devices.push_back(first.device);
+
+                bool was_silent = first.reported_silent, silent = true;
+                for (auto other : registries) {
+                    for (size_t j = 1; j < other->slot_count_; j++) {
+                        auto& slot = other->slots_[j];
+                        if (!slot.may_stay_silent || slot.device != first.device)
+                            continue;
+                        silent               = update_silence(slot) && silent;
+                        slot.reported_silent = false;
+                    }
+                }
+                first.reported_silent = silent;
+
+                if (silent && !was_silent)
+                    RCLCPP_WARN(logger, "No feedback from %s on any bus", first.name.c_str());
+                else if (!silent && was_silent)
+                    RCLCPP_INFO(logger, "Feedback from %s is back", first.name.c_str());
+            }
+        }
+    }
+
+    void report_silent_devices(const rclcpp::Logger& logger) {
+        report_silent_devices(logger, {this});
+    }
+
+private:
+    static constexpr size_t max_device_count = 32;
+
+    struct Slot {
+        void (*receive)(void*, uint64_t)    = [](void*, uint64_t) {};
+        void* device                        = nullptr;
+        std::atomic<uint64_t> receive_count = 0;
+
+        uint32_t can_id = 0;
+        std::string name;
+        bool may_stay_silent    = false;
+        uint64_t reported_count = 0;
+        bool reported_silent    = false;
+    };
+
+    // Returns whether nothing was received since the previous call.
+    static bool update_silence(Slot& slot) {
+        auto count          = slot.receive_count.load(std::memory_order::relaxed);
+        bool silent         = count == slot.reported_count;
+        slot.reported_count = count;
+        return silent;
+    }
+
+    std::string bus_name_;
+
+    // Slot 0 takes the frames of unregistered identifiers.
+    std::array<uint8_t, 2048> index_{};
+    std::array<Slot, max_device_count> slots_;
+    size_t slot_count_ = 1;
+};
+
+} // namespace rmcs_core::hardware::device
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <chrono>
+
 #include <librmcs/device/dji_motor.hpp>
 #include <rmcs_executor/component.hpp>
 
+#include "hardware/device/feedback_statistics.hpp"
+
 namespace rmcs_core::hardware::device {
 
 class DjiMotor : public librmcs::device::DjiMotor {
@@ -10,11 +14,14 @@ public:
     DjiMotor(
         rmcs_executor::Component& status_component, rmcs_executor::Component& command_component,
         const std::string& name_prefix)
-        : librmcs::device::DjiMotor() {
+        : librmcs::device::DjiMotor()
+        , feedback_(status_component, name_prefix) {
         status_component.register_output(name_prefix + "/angle", angle_, 0.0);
         status_component.register_output(name_prefix + "/velocity", velocity_, 0.0);
         status_component.register_output(name_prefix + "/torque", torque_, 0.0);
         status_component.register_output(name_prefix + "/max_torque", max_torque_, 0.0);
+        status_component.register_output(name_prefix + "/velocity_samples", velocity_samples_);
+        status_component.register_output(name_prefix + "/torque_samples", torque_samples_);
 
         command_component.register_input(name_prefix + "/control_torque", control_torque_, false);
     }
@@ -28,15 +35,40 @@ public:
 
     void configure(const Config& config) {
         librmcs::device::DjiMotor::configure(config);
+        decoder_.configure(config);
 
         *max_torque_ = max_torque();
     }
 
+    // Called from the event thread of the board. Every frame is also decoded there, so that the
+    // update sees all the samples received since the previous one.
+    void store_status(uint64_t can_data) {
+        librmcs::device::DjiMotor::store_status(can_data);
+        feedback_.record();
+
+        decoder_.store_status(can_data);
+        decoder_.update_status();
+        samples_.output().write(Aggregator::Sample{decoder_.velocity(), decoder_.torque()});
+    }
+
     void update_status() {
         librmcs::device::DjiMotor::update_status();
         *angle_    = angle();
         *velocity_ = velocity();
         *torque_   = torque();
+
+        auto samples       = samples_.read();
+        *velocity_samples_ = samples[0];
+        *torque_samples_   = samples[1];
+
+        // Outputs are stamped with the tick time the feedback was received, once per frame.
+        auto received_at = feedback_.update();
+        if (received_at != last_received_at_) {
+            angle_.stamp(received_at);
+            velocity_.stamp(received_at);
+            torque_.stamp(received_at);
+            last_received_at_ = received_at;
+        }
     }
 
     double control_torque() const {
@@ -55,6 +87,21 @@ private:
     rmcs_executor::Component::OutputInterface<double> velocity_;
     rmcs_executor::Component::OutputInterface<double> torque_;
     rmcs_executor::Component::OutputInterface<double> max_torque_;
+    rmcs_executor::Component::OutputInterface<rmcs_executor::mailbox::SampleSummary>
+        velocity_samples_, torque_samples_;
+
+    // Decodes every frame on the event thread, while the base decodes only the latest one per tick
+    // for the control thread, whose multi-turn angle, calibration and commands depend on its state.
+    // librmcs keeps the reduction ratio, direction and torque constant to itself, so decoding
+    // through it is the only way to get samples that match velocity() and torque().
+    librmcs::device::DjiMotor decoder_;
+
+    // Velocity and torque.
+    using Aggregator = rmcs_executor::mailbox::Aggregator<2>;
+    rmcs_executor::Component::AsyncInput<Aggregator::Sample, Aggregator> samples_;
+
+    FeedbackStatistics feedback_;
+    std::chrono::steady_clock::time_point last_received_at_{};
 
     rmcs_executor::Component::InputInterface<double> control_torque_;
 };
@@ -37,8 +37,8 @@ public:
         *joystick_right_ = joystick_right();
         *joystick_left_  = joystick_left();
 
-        *switch_right_ = switch_right();
-        *switch_left_  = switch_left();
+        switch_right_.set(switch_right());
+        switch_left_.set(switch_left());
 
         *mouse_velocity_ = mouse_velocity();
 
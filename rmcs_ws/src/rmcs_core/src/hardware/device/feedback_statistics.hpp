@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <rmcs_executor/component.hpp>
+
+namespace rmcs_core::hardware::device {
+
+// Receive times and counts of the feedback frames of a device, recorded by the event thread of the
+// board and published by the status component as
+//
+//   <prefix>/feedback_age   seconds since the last frame as of the update, infinite before any
+//   <prefix>/feedback_rate  frames per second, averaged over about a second
+//   <prefix>/feedback_gaps  frames counted by the gap since the previous one, in buckets of
+//                           [0, 0.5), [0.5, 1), [1, 2), [2, 4), ... [32, ∞) ms
+//
+// so that a controller notices a silent device within a few milliseconds instead of driving on
+// stale feedback. Age and rate are in tick time (/predefined/timestamp), so that they hold with a
+// simulated clock too; the gaps are between the arrivals of the frames.
+class FeedbackStatistics {
+public:
+    static constexpr size_t gap_bucket_count = 8;
+    using GapHistogram = std::array<uint64_t, gap_bucket_count>;
+
+    FeedbackStatistics(rmcs_executor::Component& status_component, const std::string& name_prefix) {
+        status_component.register_input("/predefined/timestamp", timestamp_);
+        status_component.register_output(
+            name_prefix + "/feedback_age", feedback_age_, std::numeric_limits<double>::infinity());
+        status_component.register_output(name_prefix + "/feedback_rate", feedback_rate_, 0.0);
+        status_component.register_output(
+            name_prefix + "/feedback_gaps", feedback_gaps_, GapHistogram{});
+    }
+
+    // Called from the event thread of the board on every feedback frame.
+    void record() {
+        auto now  = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto last = received_at_.load(std::memory_order::relaxed);
+        if (last != 0)
+            add(gaps_[gap_bucket(std::chrono::steady_clock::duration{now - last})], 1);
+        received_at_.store(now, std::memory_order::relaxed);
+        // Released with the count, so that whoever sees the count also sees the time of its frame.
+        frame_count_.store(
+            frame_count_.load(std::memory_order::relaxed) + 1, std::memory_order::release);
+    }
+
+    // Called from the update of the status component. Returns when the last frame was received in
+    // tick time, that is the tick timestamp less how long ago it arrived, or the epoch if none was.
+    std::chrono::steady_clock::time_point update() {
+        auto now         = *timestamp_;
+        auto frame_count = frame_count_.load(std::memory_order::acquire);
+        if (frame_count != stamped_frame_count_) {
+            auto arrived_at = std::chrono::steady_clock::time_point{
+                std::chrono::steady_clock::duration{received_at_.load(std::memory_order::relaxed)}};
+            auto delay = std::max(
+                std::chrono::steady_clock::now() - arrived_at,
+                std::chrono::steady_clock::duration::zero());
+            received_at_tick_    = now - delay;
+            stamped_frame_count_ = frame_count;
+        }
+
+        *feedback_age_ = stamped_frame_count_ == 0
+                           ? std::numeric_limits<double>::infinity()
+                           : std::chrono::duration<double>(now - received_at_tick_).count();
+
+        if (rate_window_begin_ == std::chrono::steady_clock::time_point{}) {
+            rate_window_begin_       = now;
+            rate_window_frame_count_ = frame_count;
+        } else if (auto elapsed = now - rate_window_begin_; elapsed >= std::chrono::seconds(1)) {
+            *feedback_rate_ = static_cast<double>(frame_count - rate_window_frame_count_)
+                            / std::chrono::duration<double>(elapsed).count();
+            rate_window_begin_       = now;
+            rate_window_frame_count_ = frame_count;
+        }
+
+        for (size_t i = 0; i < gap_bucket_count; i++)
+            (*feedback_gaps_)[i] = gaps_[i].load(std::memory_order::relaxed);
+
+        return received_at_tick_;
+    }
+
+private:
+    static size_t gap_bucket(std::chrono::steady_clock::duration gap) {
+        auto half_milliseconds = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(gap).count() / 500);
+        return std::min<size_t>(std::bit_width(half_milliseconds), gap_bucket_count - 1);
+    }
+
+    // Counters have a single writer each.
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order::relaxed) + value, std::memory_order::relaxed);
+    }
+
+    std::atomic<std::chrono::steady_clock::rep> received_at_ = 0;
+    std::atomic<uint64_t> frame_count_                      = 0;
+    std::array<std::atomic<uint64_t>, gap_bucket_count> gaps_{};
+
+    std::chrono::steady_clock::time_point received_at_tick_{};
+    uint64_t stamped_frame_count_ = 0;
+
+    std::chrono::steady_clock::time_point rate_window_begin_{};
+    uint64_t rate_window_frame_count_ = 0;
+
+    rmcs_executor::Component::InputInterface<std::chrono::steady_clock::time_point> timestamp_;
+
+    rmcs_executor::Component::OutputInterface<double> feedback_age_;
+    rmcs_executor::Component::OutputInterface<double> feedback_rate_;
+    rmcs_executor::Component::OutputInterface<GapHistogram> feedback_gaps_;
+};
+
+} // namespace rmcs_core::hardware::device
\ No newline at end of file
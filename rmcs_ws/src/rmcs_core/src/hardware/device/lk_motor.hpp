@@ -1,10 +1,14 @@
 #pragma once
 
+#include <chrono>
+
 #include <librmcs/device/lk_motor.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <rmcs_executor/component.hpp>
 
+#include "hardware/device/feedback_statistics.hpp"
+
 namespace rmcs_core::hardware::device {
 
 class LkMotor : public librmcs::device::LkMotor {
@@ -12,7 +16,8 @@ public:
     LkMotor(
         rmcs_executor::Component& status_component, rmcs_executor::Component& command_component,
         const std::string& name_prefix)
-        : librmcs::device::LkMotor() {
+        : librmcs::device::LkMotor()
+        , feedback_(status_component, name_prefix) {
         status_component.register_output(name_prefix + "/angle", angle_, 0.0);
         status_component.register_output(name_prefix + "/velocity", velocity_, 0.0);
         status_component.register_output(name_prefix + "/torque", torque_, 0.0);
@@ -35,11 +40,26 @@ public:
         *max_torque_ = max_torque();
     }
 
+    // Called from the event thread of the board.
+    void store_status(uint64_t can_data) {
+        librmcs::device::LkMotor::store_status(can_data);
+        feedback_.record();
+    }
+
     void update_status() {
         librmcs::device::LkMotor::update_status();
         *angle_    = angle();
         *velocity_ = velocity();
         *torque_   = torque();
+
+        // Outputs are stamped with the tick time the feedback was received, once per frame.
+        auto received_at = feedback_.update();
+        if (received_at != last_received_at_) {
+            angle_.stamp(received_at);
+            velocity_.stamp(received_at);
+            torque_.stamp(received_at);
+            last_received_at_ = received_at;
+        }
     }
 
     double control_velocity() const {
@@ -59,6 +79,9 @@ private:
     rmcs_executor::Component::OutputInterface<double> torque_;
     rmcs_executor::Component::OutputInterface<double> max_torque_;
 
+    FeedbackStatistics feedback_;
+    std::chrono::steady_clock::time_point last_received_at_{};
+
     rmcs_executor::Component::InputInterface<double> control_velocity_;
 };
 
@@ -16,6 +16,10 @@ public:
         status_component.register_output("/chassis/voltage", chassis_voltage_, 0.0);
         status_component.register_output("/chassis/supercap/voltage", supercap_voltage_, 0.0);
         status_component.register_output("/chassis/supercap/enabled", supercap_enabled_, false);
+        status_component.register_output("/chassis/power_samples", chassis_power_samples_);
+        status_component.register_output("/chassis/voltage_samples", chassis_voltage_samples_);
+        status_component.register_output(
+            "/chassis/supercap/voltage_samples", supercap_voltage_samples_);
 
         command_component.register_input(
             "/chassis/supercap/control_enable", supercap_control_enabled_);
@@ -23,17 +27,26 @@ public:
             "/chassis/supercap/charge_power_limit", supercap_charge_power_limit_);
     }
 
+    // Called from the event thread of the board.
     void store_status(uint64_t can_data) {
-        can_data_.store(std::bit_cast<SupercapStatus>(can_data), std::memory_order::relaxed);
+        auto status = std::bit_cast<SupercapStatus>(can_data);
+        samples_.output().write(Aggregator::Sample{
+            uint_to_double(status.chassis_power, 0.0, 500.0),
+            uint_to_double(status.chassis_voltage, 0.0, 50.0),
+            uint_to_double(status.supercap_voltage, 0.0, 50.0), status.enabled ? 1.0 : 0.0});
     }
 
     void update_status() {
-        auto status = can_data_.load(std::memory_order::relaxed);
+        auto [chassis_power, chassis_voltage, supercap_voltage, enabled] = samples_.read();
 
-        *chassis_power_    = uint_to_double(status.chassis_power, 0.0, 500.0);
-        *chassis_voltage_  = uint_to_double(status.chassis_voltage, 0.0, 50.0);
-        *supercap_voltage_ = uint_to_double(status.supercap_voltage, 0.0, 50.0);
-        *supercap_enabled_ = status.enabled;
+        *chassis_power_    = chassis_power.latest;
+        *chassis_voltage_  = chassis_voltage.latest;
+        *supercap_voltage_ = supercap_voltage.latest;
+        *supercap_enabled_ = enabled.latest != 0.0;
+
+        *chassis_power_samples_    = chassis_power;
+        *chassis_voltage_samples_  = chassis_voltage;
+        *supercap_voltage_samples_ = supercap_voltage;
     }
 
     uint16_t generate_command() const {
@@ -65,8 +78,9 @@ private:
         uint8_t enabled;
         uint8_t unused;
     };
-    std::atomic<SupercapStatus> can_data_{};
-    static_assert(decltype(can_data_)::is_always_lock_free);
+    // Chassis power, chassis voltage, supercap voltage and enabled (as 0 or 1).
+    using Aggregator = rmcs_executor::mailbox::Aggregator<4>;
+    Component::AsyncInput<Aggregator::Sample, Aggregator> samples_;
 
     struct __attribute__((packed, aligned(2))) SupercapCommand {
         uint8_t power_limit;
@@ -78,6 +92,10 @@ private:
     Component::OutputInterface<double> supercap_voltage_;
     Component::OutputInterface<bool> supercap_enabled_;
 
+    Component::OutputInterface<rmcs_executor::mailbox::SampleSummary> chassis_power_samples_;
+    Component::OutputInterface<rmcs_executor::mailbox::SampleSummary> chassis_voltage_samples_;
+    Component::OutputInterface<rmcs_executor::mailbox::SampleSummary> supercap_voltage_samples_;
+
     Component::InputInterface<bool> supercap_control_enabled_;
     Component::InputInterface<double> supercap_charge_power_limit_;
 };
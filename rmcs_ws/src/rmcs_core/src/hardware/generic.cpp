@@ -0,0 +1,676 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <rclcpp/node.hpp>
+#include <rmcs_description/tf_description.hpp>
+#include <rmcs_executor/component.hpp>
+#include <rmcs_executor/trace.hpp>
+#include <rmcs_msgs/serial_interface.hpp>
+#include <std_msgs/msg/int32.hpp>
+
+#include "hardware/board/backend.hpp"
+#include "hardware/board/usb_backend.hpp"
+#include "hardware/board/virtual_backend.hpp"
+#include "hardware/device/bmi088.hpp"
+#include "hardware/device/can_registry.hpp"
+#include "hardware/device/dji_motor.hpp"
+#include "hardware/device/dr16.hpp"
+#include "hardware/device/lk_motor.hpp"
+#include "hardware/device/supercap.hpp"
+
+namespace rmcs_core::hardware {
+
+// Hardware of a robot described by its parameters instead of a class of its own: the boards, the
+// devices on their CAN buses, and the joints of the tf tree their angles drive.
+//
+//   boards: ["top", "bottom"]
+//   board.top.usb_pid: 0x1234        # -1 for any board
+//   board.top.can_record_path: ""    # Record the received CAN frames, to be replayed
+//   board.bottom.backend: "virtual"  # Simulated in-process instead of "usb"
+//   board.bottom.virtual.rate: 1000.0
+//   board.bottom.virtual.can_trace_path: "" # Replay instead of simulating the devices
+//   board.bottom.virtual.stepped: false  # Advanced by the update, e.g. with `clock: simulated`
+//   board.bottom.dr16: true          # Remote receiver on the dbus port
+//   board.bottom.referee: true       # Referee serial on uart1
+//
+//   imu_board: "top"                 # Board whose IMU is mounted on the pitch link
+//   imu.rotation: 3.1416             # Yaw of the IMU in the pitch link (rad)
+//   imu.yaw_velocity: "gz"           # Axes giving /gimbal/{yaw,pitch}/velocity_imu, e.g. "-gy"
+//   imu.pitch_velocity: "gx"
+//
+//   tf.gimbal_center_height: 0.32    # Optional static transforms of the chassis (m)
+//   tf.wheel_distance_x: 0.16
+//   tf.wheel_distance_y: 0.16
+//
+//   devices: ["yaw", "left_front_wheel", "supercap"]
+//   device.yaw.type: "GM6020"        # M3508, M2006, GM6020, MG5010E_I10 or supercap
+//   device.yaw.board: "top"
+//   device.yaw.bus: 1                # Or a list of buses the device may be wired to
+//   device.yaw.id: 0x205             # Identifier of its feedback frames
+//   device.yaw.name: "/gimbal/yaw"   # Prefix of its outputs and inputs
+//   device.yaw.joint: "yaw"          # yaw, pitch or <left|right>_<front|back>_wheel
+//   device.yaw.zero_point: 3387      # Encoder zero point, reset on /gimbal/calibrate
+//   device.yaw.reversed: false       # DJI motors only, with reduction_ratio and multi_turn
+//   device.yaw.imu_feedforward: true # LK motors only, subtract gz of the IMU of their board
+//
+// Commands of DJI motors and of the supercap are packed into the shared frames of their protocol
+// (0x200, 0x1FF, 0x1FE, 0x2FE), of which only those with at least one device are sent. Commands
+// of LK motors take a frame of their own.
+class Generic
+    : public rmcs_executor::Component
+    , public rclcpp::Node {
+public:
+    using rclcpp::Node::get_logger;
+    using rclcpp::Node::get_parameter;
+    using rclcpp::Node::has_parameter;
+
+    Generic()
+        : Node{
+              get_component_name(),
+              rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)}
+        , command_component_(
+              create_partner_component<GenericCommand>(get_component_name() + "_command", *this)) {
+        register_input("/predefined/timestamp", timestamp_);
+        register_output("/tf", tf_);
+
+        for (const auto& board_name : get_parameter("boards").as_string_array()) {
+            auto prefix = "board." + board_name + ".";
+            auto& board = *boards_.emplace_back(std::make_unique<Board>(*this, board_name));
+            if (parameter_or(prefix + "dr16", false))
+                board.enable_dr16(*this);
+            if (parameter_or(prefix + "referee", false))
+                board.enable_referee(*this);
+        }
+
+        for (const auto& device_name : get_parameter("devices").as_string_array())
+            add_device(device_name);
+
+        init_imu();
+        init_static_transforms();
+
+        gimbal_calibrate_subscription_ = create_subscription<std_msgs::msg::Int32>(
+            "/gimbal/calibrate", rclcpp::QoS{0}, [this](std_msgs::msg::Int32::UniquePtr&&) {
+                defer([this]() { calibrate_zero_points(); });
+            });
+
+        can_report_timer_ = create_wall_timer(std::chrono::seconds(1), [this]() {
+            for (auto& board : boards_) {
+                device::CanRegistry::report_silent_devices(
+                    get_logger(), {&board->can1_registry_, &board->can2_registry_});
+                if (board->virtual_backend_)
+                    report_virtual_board_statistics(*board);
+            }
+        });
+
+        // Started last, so that frames are only dispatched to registered devices.
+        for (auto& board : boards_)
+            board->start();
+    }
+
+    void update() override {
+        for (auto& board : boards_)
+            board->update(*timestamp_);
+
+        for (auto& motor : dji_motors_)
+            motor.update_status();
+        for (auto& motor : lk_motors_)
+            motor.update_status();
+        if (supercap_)
+            supercap_->update_status();
+
+        for (auto& joint : joints_)
+            joint.set_state(*tf_, joint.angle(joint.motor));
+
+        if (imu_) {
+            Eigen::Quaterniond gimbal_imu_pose{imu_->q0(), imu_->q1(), imu_->q2(), imu_->q3()};
+            tf_->set_transform<rmcs_description::ImuLink, rmcs_description::OdomImu>(
+                gimbal_imu_pose.conjugate());
+            *gimbal_yaw_velocity_imu_   = imu_yaw_velocity_.read(*imu_);
+            *gimbal_pitch_velocity_imu_ = imu_pitch_velocity_.read(*imu_);
+        }
+    }
+
+    void command_update() {
+        for (auto& board : boards_)
+            board->command_update();
+    }
+
+private:
+    template <typename T>
+    T parameter_or(const std::string& name, T value) {
+        get_parameter(name, value);
+        return value;
+    }
+
+    struct CommandSlot {
+        void* device                = nullptr;
+        uint16_t (*generate)(void*) = nullptr;
+    };
+    // Sent on every command update, packing the 16-bit commands of up to four devices, or carrying
+    // the 64-bit command of a single one.
+    struct CommandFrame {
+        int bus;
+        uint32_t can_id;
+        std::array<CommandSlot, 4> slots{};
+
+        void* device                = nullptr;
+        uint64_t (*generate)(void*) = nullptr;
+    };
+
+    class Board final : private board::Callbacks {
+    public:
+        friend class Generic;
+
+        Board(Generic& generic, std::string name)
+            : name_(std::move(name))
+            , can1_registry_{name_ + " can1"}
+            , can2_registry_{name_ + " can2"} {
+            auto prefix     = "board." + name_ + ".";
+            auto backend    = generic.parameter_or<std::string>(prefix + "backend", "usb");
+            auto& callbacks = static_cast<board::Callbacks&>(*this);
+            if (backend == "usb") {
+                auto usb_pid =
+                    static_cast<int>(generic.parameter_or<int64_t>(prefix + "usb_pid", -1));
+                backend_     = std::make_unique<board::UsbBackend>(
+                    callbacks, usb_pid,
+                    generic.parameter_or<std::string>(prefix + "can_record_path", ""));
+            } else if (backend == "virtual") {
+                board::VirtualBackend::Config config;
+                config.rate           = generic.parameter_or(prefix + "virtual.rate", 1000.0);
+                config.can_trace_path =
+                    generic.parameter_or<std::string>(prefix + "virtual.can_trace_path", "");
+                config.stepped = generic.parameter_or(prefix + "virtual.stepped", false);
+
+                auto virtual_backend = std::make_unique<board::VirtualBackend>(callbacks, config);
+                virtual_backend_     = virtual_backend.get();
+                backend_             = std::move(virtual_backend);
+            } else {
+                throw std::invalid_argument{"Unknown backend of board " + name_ + ": " + backend};
+            }
+            thread_name_ = generic.get_component_name() + " " + name_ + " " + backend + " events";
+        }
+
+        ~Board() final {
+            if (event_thread_.joinable()) {
+                backend_->stop();
+                event_thread_.join();
+            }
+        }
+
+        void enable_dr16(Component& component) { dr16_.emplace(component); }
+
+        void enable_referee(Component& component) {
+            component.register_output("/referee/serial", referee_serial_);
+            referee_serial_->read = [this](std::byte* buffer, size_t size) {
+                return referee_receive_.read(buffer, size);
+            };
+            referee_serial_->write = [this](const std::byte* buffer, size_t size) {
+                backend_->add_uart1_transmission(buffer, size);
+                return size;
+            };
+        }
+
+        device::CanRegistry& can_registry(int bus) {
+            if (bus == 1)
+                return can1_registry_;
+            if (bus == 2)
+                return can2_registry_;
+            throw std::invalid_argument{"No CAN bus " + std::to_string(bus) + " on " + name_};
+        }
+
+        // Packs a 16-bit command into the frame of this identifier, sent once per command update.
+        void add_command_slot(int bus, uint32_t can_id, size_t index, CommandSlot slot) {
+            auto& frame = find_or_add_frame(bus, can_id);
+            if (frame.generate || frame.slots[index].device)
+                throw std::invalid_argument{
+                    "Command slot " + std::to_string(index) + " of frame " + std::to_string(can_id)
+                    + " taken twice on " + name_};
+            frame.slots[index] = slot;
+        }
+
+        // Sends the 64-bit command of a device taking the whole frame.
+        void add_command_frame(
+            int bus, uint32_t can_id, void* device, uint64_t (*generate)(void*)) {
+            auto& frame = find_or_add_frame(bus, can_id);
+            if (frame.generate
+                || std::ranges::any_of(frame.slots, [](auto& slot) { return slot.device; }))
+                throw std::invalid_argument{
+                    "Command frame " + std::to_string(can_id) + " taken twice on " + name_};
+            frame.device   = device;
+            frame.generate = generate;
+        }
+
+        void start() {
+            event_thread_ = std::thread{[this]() {
+                rmcs_executor::trace::set_thread_name(thread_name_);
+                backend_->run();
+            }};
+        }
+
+        // Stepped boards deliver the feedback of the tick right here, on the control thread.
+        void update(std::chrono::steady_clock::time_point timestamp) {
+            if (virtual_backend_ && virtual_backend_->stepped())
+                virtual_backend_->step(timestamp);
+            bmi088_.update_status();
+            if (dr16_)
+                dr16_->update_status();
+        }
+
+        void command_update() {
+            for (auto& frame : command_frames_) {
+                uint64_t can_data;
+                if (frame.generate) {
+                    can_data = frame.generate(frame.device);
+                } else {
+                    uint16_t can_commands[4];
+                    for (size_t i = 0; i < 4; i++) {
+                        auto& slot      = frame.slots[i];
+                        can_commands[i] = slot.device ? slot.generate(slot.device) : 0;
+                    }
+                    can_data = std::bit_cast<uint64_t>(can_commands);
+                }
+                backend_->add_can_transmission(frame.bus, frame.can_id, can_data);
+            }
+
+            rmcs_executor::trace::Scope scope{"trigger_transmission", "usb"};
+            backend_->trigger_transmission();
+        }
+
+        device::Bmi088& imu() { return bmi088_; }
+
+    private:
+        CommandFrame& find_or_add_frame(int bus, uint32_t can_id) {
+            can_registry(bus);
+            for (auto& frame : command_frames_) {
+                if (frame.bus == bus && frame.can_id == can_id)
+                    return frame;
+            }
+            return command_frames_.emplace_back(CommandFrame{.bus = bus, .can_id = can_id});
+        }
+
+        void can1_receive_callback(
+            uint32_t can_id, uint64_t can_data, bool is_extended_can_id,
+            bool is_remote_transmission, uint8_t can_data_length) override {
+            rmcs_executor::trace::Scope scope{"can1_receive", "usb"};
+            if (is_extended_can_id || is_remote_transmission || can_data_length < 8) [[unlikely]]
+                return;
+            can1_registry_.dispatch(can_id, can_data);
+        }
+
+        void can2_receive_callback(
+            uint32_t can_id, uint64_t can_data, bool is_extended_can_id,
+            bool is_remote_transmission, uint8_t can_data_length) override {
+            rmcs_executor::trace::Scope scope{"can2_receive", "usb"};
+            if (is_extended_can_id || is_remote_transmission || can_data_length < 8) [[unlikely]]
+                return;
+            can2_registry_.dispatch(can_id, can_data);
+        }
+
+        void uart1_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) override {
+            rmcs_executor::trace::Scope scope{"uart1_receive", "usb"};
+            referee_receive_.output().write(uart_data, uart_data_length);
+        }
+
+        void dbus_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) override {
+            rmcs_executor::trace::Scope scope{"dbus_receive", "usb"};
+            if (dr16_)
+                dr16_->store_status(uart_data, uart_data_length);
+        }
+
+        void accelerometer_receive_callback(int16_t x, int16_t y, int16_t z) override {
+            rmcs_executor::trace::Scope scope{"accelerometer_receive", "usb"};
+            bmi088_.store_accelerometer_status(x, y, z);
+        }
+
+        void gyroscope_receive_callback(int16_t x, int16_t y, int16_t z) override {
+            rmcs_executor::trace::Scope scope{"gyroscope_receive", "usb"};
+            bmi088_.store_gyroscope_status(x, y, z);
+        }
+
+        std::string name_, thread_name_;
+
+        device::Bmi088 bmi088_{1000, 0.2, 0.0};
+        std::optional<device::Dr16> dr16_;
+
+        AsyncInput<std::byte, rmcs_executor::mailbox::SpscQueue<std::byte, 256>> referee_receive_;
+        OutputInterface<rmcs_msgs::SerialInterface> referee_serial_;
+
+        device::CanRegistry can1_registry_;
+        device::CanRegistry can2_registry_;
+        std::vector<CommandFrame> command_frames_;
+
+        std::unique_ptr<board::Backend> backend_;
+        board::VirtualBackend* virtual_backend_ = nullptr;
+        board::VirtualBackend::Statistics reported_statistics_{};
+
+        std::thread event_thread_;
+    };
+
+    Board& find_board(const std::string& name) {
+        for (auto& board : boards_) {
+            if (board->name_ == name)
+                return *board;
+        }
+        throw std::invalid_argument{"Unknown board: " + name};
+    }
+
+    // Command frame and slot of a DJI motor with the given feedback identifier: C620 and C610
+    // controllers (M3508, M2006) answer 0x200 and 0x1FF, GM6020 in current mode 0x1FE and 0x2FE.
+    static std::pair<uint32_t, size_t>
+        dji_command_slot(device::DjiMotor::Type type, uint32_t feedback_id) {
+        if (type == device::DjiMotor::Type::GM6020) {
+            if (feedback_id >= 0x205 && feedback_id <= 0x208)
+                return {0x1FE, feedback_id - 0x205};
+            if (feedback_id >= 0x209 && feedback_id <= 0x20B)
+                return {0x2FE, feedback_id - 0x209};
+        } else {
+            if (feedback_id >= 0x201 && feedback_id <= 0x204)
+                return {0x200, feedback_id - 0x201};
+            if (feedback_id >= 0x205 && feedback_id <= 0x208)
+                return {0x1FF, feedback_id - 0x205};
+        }
+        throw std::invalid_argument{
+            "Invalid feedback identifier of a DJI motor: " + std::to_string(feedback_id)};
+    }
+
+    void add_device(const std::string& device_name) {
+        auto prefix = "device." + device_name + ".";
+        auto type   = get_parameter(prefix + "type").as_string();
+        auto& board = find_board(get_parameter(prefix + "board").as_string());
+        auto id     = static_cast<uint32_t>(get_parameter(prefix + "id").as_int());
+
+        std::vector<int> buses;
+        auto bus_parameter = get_parameter(prefix + "bus");
+        if (bus_parameter.get_type() == rclcpp::ParameterType::PARAMETER_INTEGER_ARRAY) {
+            for (auto bus : bus_parameter.as_integer_array())
+                buses.push_back(static_cast<int>(bus));
+        } else {
+            buses.push_back(static_cast<int>(bus_parameter.as_int()));
+        }
+        // A device wired to either of several buses stays silent on the others.
+        bool may_stay_silent = buses.size() > 1;
+
+        if (type == "supercap") {
+            if (supercap_)
+                throw std::invalid_argument{"Only one supercap is supported"};
+            auto& supercap = supercap_.emplace(*this, *command_component_);
+            for (auto bus : buses) {
+                board.can_registry(bus).register_device(id, supercap, device_name, may_stay_silent);
+                // The supercap controller takes the place of a fourth GM6020.
+                board.add_command_slot(bus, 0x1FE, 3, {&supercap, [](void* device) -> uint16_t {
+                    return static_cast<device::Supercap*>(device)->generate_command();
+                }});
+                if (board.virtual_backend_)
+                    board.virtual_backend_->add_supercap(bus, id);
+            }
+            return;
+        }
+
+        auto name = get_parameter(prefix + "name").as_string();
+        std::optional<int64_t> zero_point;
+        if (has_parameter(prefix + "zero_point"))
+            zero_point = get_parameter(prefix + "zero_point").as_int();
+
+        if (type == "MG5010E_I10") {
+            auto config = device::LkMotor::Config{device::LkMotor::Type::MG5010E_I10};
+            if (zero_point)
+                config.set_encoder_zero_point(static_cast<int>(*zero_point));
+            auto& motor = lk_motors_.emplace_back(*this, *command_component_, name, config);
+            if (zero_point)
+                calibrated_lk_motors_.emplace_back(name, &motor);
+            add_joint(prefix, motor);
+
+            void* command_device;
+            uint64_t (*generate)(void*);
+            if (parameter_or(prefix + "imu_feedforward", false)) {
+                command_device = &lk_feedforwards_.emplace_back(motor, board.imu());
+                generate       = [](void* device) -> uint64_t {
+                    auto& feedforward = *static_cast<LkFeedforward*>(device);
+                    return feedforward.motor.generate_velocity_command(
+                        feedforward.motor.control_velocity() - feedforward.imu.gz());
+                };
+            } else {
+                command_device = &motor;
+                generate       = [](void* device) -> uint64_t {
+                    return static_cast<device::LkMotor*>(device)->generate_command();
+                };
+            }
+            for (auto bus : buses) {
+                board.can_registry(bus).register_device(id, motor, name, may_stay_silent);
+                board.add_command_frame(bus, id, command_device, generate);
+                if (board.virtual_backend_)
+                    board.virtual_backend_->add_lk_motor(bus, id);
+            }
+            return;
+        }
+
+        device::DjiMotor::Type dji_type;
+        if (type == "M3508")
+            dji_type = device::DjiMotor::Type::M3508;
+        else if (type == "M2006")
+            dji_type = device::DjiMotor::Type::M2006;
+        else if (type == "GM6020")
+            dji_type = device::DjiMotor::Type::GM6020;
+        else
+            throw std::invalid_argument{"Unknown type of device " + device_name + ": " + type};
+
+        auto config = device::DjiMotor::Config{dji_type};
+        if (parameter_or(prefix + "reversed", false))
+            config.set_reversed();
+        if (has_parameter(prefix + "reduction_ratio"))
+            config.set_reduction_ratio(get_parameter(prefix + "reduction_ratio").as_double());
+        if (parameter_or(prefix + "multi_turn", false))
+            config.enable_multi_turn_angle();
+        if (zero_point)
+            config.set_encoder_zero_point(static_cast<int>(*zero_point));
+
+        auto& motor = dji_motors_.emplace_back(*this, *command_component_, name, config);
+        if (zero_point)
+            calibrated_dji_motors_.emplace_back(name, &motor);
+        add_joint(prefix, motor);
+
+        auto [command_id, index] = dji_command_slot(dji_type, id);
+        for (auto bus : buses) {
+            board.can_registry(bus).register_device(id, motor, name, may_stay_silent);
+            board.add_command_slot(bus, command_id, index, {&motor, [](void* device) -> uint16_t {
+                return static_cast<device::DjiMotor*>(device)->generate_command();
+            }});
+            if (board.virtual_backend_)
+                board.virtual_backend_->add_dji_motor(bus, id, command_id, index);
+        }
+    }
+
+    struct Joint {
+        void (*set_state)(rmcs_description::Tf&, double);
+        void* motor;
+        double (*angle)(void*);
+    };
+
+    template <typename Motor>
+    void add_joint(const std::string& prefix, Motor& motor) {
+        std::string joint_name;
+        if (!get_parameter(prefix + "joint", joint_name))
+            return;
+
+        using namespace rmcs_description;
+        auto& joint = joints_.emplace_back();
+        joint.motor = &motor;
+        joint.angle = [](void* motor) { return static_cast<Motor*>(motor)->angle(); };
+        if (joint_name == "yaw")
+            joint.set_state = [](Tf& tf, double angle) {
+                tf.set_state<GimbalCenterLink, YawLink>(angle);
+            };
+        else if (joint_name == "pitch")
+            joint.set_state = [](Tf& tf, double angle) { tf.set_state<YawLink, PitchLink>(angle); };
+        else if (joint_name == "left_front_wheel")
+            joint.set_state = [](Tf& tf, double angle) {
+                tf.set_state<BaseLink, LeftFrontWheelLink>(angle);
+            };
+        else if (joint_name == "left_back_wheel")
+            joint.set_state = [](Tf& tf, double angle) {
+                tf.set_state<BaseLink, LeftBackWheelLink>(angle);
+            };
+        else if (joint_name == "right_back_wheel")
+            joint.set_state = [](Tf& tf, double angle) {
+                tf.set_state<BaseLink, RightBackWheelLink>(angle);
+            };
+        else if (joint_name == "right_front_wheel")
+            joint.set_state = [](Tf& tf, double angle) {
+                tf.set_state<BaseLink, RightFrontWheelLink>(angle);
+            };
+        else
+            throw std::invalid_argument{"Unknown joint: " + joint_name};
+    }
+
+    // One axis of the gyroscope, possibly negated, e.g. "-gy".
+    struct ImuAxis {
+        int index     = 2;
+        double factor = 1.0;
+
+        static ImuAxis parse(const std::string& text) {
+            bool negated = text.starts_with('-');
+            auto axis    = negated ? text.substr(1) : text;
+            if (axis != "gx" && axis != "gy" && axis != "gz")
+                throw std::invalid_argument{"Unknown axis of the gyroscope: " + text};
+            return {axis[1] - 'x', negated ? -1.0 : 1.0};
+        }
+
+        // Latest sample, as the gimbal controllers are tuned for.
+        double read(device::Bmi088& imu) const {
+            return factor * (index == 0 ? imu.gx() : index == 1 ? imu.gy() : imu.gz());
+        }
+    };
+
+    void init_imu() {
+        std::string board_name;
+        if (!get_parameter("imu_board", board_name))
+            return;
+        imu_ = &find_board(board_name).imu();
+        imu_->register_outputs(*this);
+
+        imu_yaw_velocity_   = ImuAxis::parse(parameter_or<std::string>("imu.yaw_velocity", "gz"));
+        imu_pitch_velocity_ = ImuAxis::parse(parameter_or<std::string>("imu.pitch_velocity", "gx"));
+        register_output("/gimbal/yaw/velocity_imu", gimbal_yaw_velocity_imu_);
+        register_output("/gimbal/pitch/velocity_imu", gimbal_pitch_velocity_imu_);
+
+        tf_->set_transform<rmcs_description::PitchLink, rmcs_description::ImuLink>(
+            Eigen::AngleAxisd{parameter_or("imu.rotation", 0.0), Eigen::Vector3d::UnitZ()});
+    }
+
+    void init_static_transforms() {
+        using namespace rmcs_description;
+
+        double gimbal_center_height;
+        if (get_parameter("tf.gimbal_center_height", gimbal_center_height))
+            tf_->set_transform<BaseLink, GimbalCenterLink>(
+                Eigen::Translation3d{0, 0, gimbal_center_height});
+
+        double wheel_distance_x, wheel_distance_y;
+        if (get_parameter("tf.wheel_distance_x", wheel_distance_x)
+            && get_parameter("tf.wheel_distance_y", wheel_distance_y)) {
+            tf_->set_transform<BaseLink, LeftFrontWheelLink>(
+                Eigen::Translation3d{wheel_distance_x / 2, wheel_distance_y / 2, 0});
+            tf_->set_transform<BaseLink, LeftBackWheelLink>(
+                Eigen::Translation3d{-wheel_distance_x / 2, wheel_distance_y / 2, 0});
+            tf_->set_transform<BaseLink, RightBackWheelLink>(
+                Eigen::Translation3d{-wheel_distance_x / 2, -wheel_distance_y / 2, 0});
+            tf_->set_transform<BaseLink, RightFrontWheelLink>(
+                Eigen::Translation3d{wheel_distance_x / 2, -wheel_distance_y / 2, 0});
+        }
+    }
+
+    // Frames simulated by the board and commands sent to it in the last period, with the mean
+    // time spent in the receive callbacks and in adding each command.
+    void report_virtual_board_statistics(Board& board) {
+        auto statistics = board.virtual_backend_->statistics();
+        auto& last      = board.reported_statistics_;
+        auto mean       = [](uint64_t time_ns, uint64_t count) {
+            return count ? static_cast<double>(time_ns) / static_cast<double>(count) : 0.0;
+        };
+        RCLCPP_INFO(
+            get_logger(),
+            "Virtual board %s: %lu frames received (%.0f ns each), %lu frames transmitted "
+            "(%.0f ns each)",
+            board.name_.c_str(), statistics.received_frames - last.received_frames,
+            mean(
+                statistics.receive_time_ns - last.receive_time_ns,
+                statistics.received_frames - last.received_frames),
+            statistics.transmitted_frames - last.transmitted_frames,
+            mean(
+                statistics.transmit_time_ns - last.transmit_time_ns,
+                statistics.transmitted_frames - last.transmitted_frames));
+        last = statistics;
+    }
+
+    void calibrate_zero_points() {
+        for (auto& [name, motor] : calibrated_dji_motors_)
+            RCLCPP_INFO(
+                get_logger(), "[calibration] New zero point of %s: %ld", name.c_str(),
+                static_cast<long>(motor->calibrate_zero_point()));
+        for (auto& [name, motor] : calibrated_lk_motors_)
+            RCLCPP_INFO(
+                get_logger(), "[calibration] New zero point of %s: %ld", name.c_str(),
+                static_cast<long>(motor->calibrate_zero_point()));
+    }
+
+    class GenericCommand : public rmcs_executor::Component {
+    public:
+        explicit GenericCommand(Generic& generic)
+            : generic_(generic) {
+            // Sends the referee serial, which other components write to.
+            register_shared_state(rmcs_msgs::SerialInterface::shared_state);
+        }
+
+        void update() override { generic_.command_update(); }
+
+        Generic& generic_;
+    };
+    std::shared_ptr<GenericCommand> command_component_;
+
+    InputInterface<std::chrono::steady_clock::time_point> timestamp_;
+    OutputInterface<rmcs_description::Tf> tf_;
+
+    // Devices are kept in place, the boards dispatch feedback to them by address.
+    std::deque<device::DjiMotor> dji_motors_;
+    std::deque<device::LkMotor> lk_motors_;
+    std::optional<device::Supercap> supercap_;
+
+    struct LkFeedforward {
+        device::LkMotor& motor;
+        device::Bmi088& imu;
+    };
+    std::deque<LkFeedforward> lk_feedforwards_;
+
+    std::vector<Joint> joints_;
+    std::vector<std::pair<std::string, device::DjiMotor*>> calibrated_dji_motors_;
+    std::vector<std::pair<std::string, device::LkMotor*>> calibrated_lk_motors_;
+
+    device::Bmi088* imu_ = nullptr;
+    ImuAxis imu_yaw_velocity_, imu_pitch_velocity_;
+    OutputInterface<double> gimbal_yaw_velocity_imu_;
+    OutputInterface<double> gimbal_pitch_velocity_imu_;
+
+    // Requested from the ROS spin thread, but deferred to the control thread so as not to race
+    // with the motors.
+    rclcpp::Subscription<std_msgs::msg::Int32>::SharedPtr gimbal_calibrate_subscription_;
+    rclcpp::TimerBase::SharedPtr can_report_timer_;
+
+    // Declared last, so that the boards stop dispatching feedback before the devices are gone.
+    std::vector<std::unique_ptr<Board>> boards_;
+};
+
+} // namespace rmcs_core::hardware
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(rmcs_core::hardware::Generic, rmcs_executor::Component)
\ No newline at end of file
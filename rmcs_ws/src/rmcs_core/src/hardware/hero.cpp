@@ -1,14 +1,17 @@
+#include <chrono>
 #include <memory>
 
 #include <rclcpp/node.hpp>
 #include <rmcs_description/tf_description.hpp>
 #include <rmcs_executor/component.hpp>
+#include <rmcs_executor/trace.hpp>
 #include <rmcs_msgs/serial_interface.hpp>
 #include <std_msgs/msg/int32.hpp>
 
 #include <librmcs/client/cboard.hpp>
 
 #include "hardware/device/bmi088.hpp"
+#include "hardware/device/can_registry.hpp"
 #include "hardware/device/dji_motor.hpp"
 #include "hardware/device/dr16.hpp"
 #include "hardware/device/lk_motor.hpp"
@@ -20,6 +23,9 @@ class Hero
     : public rmcs_executor::Component
     , public rclcpp::Node {
 public:
+    using rclcpp::Node::get_logger;
+    using rclcpp::Node::get_parameter;
+
     Hero()
         : Node{get_component_name(), rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)}
         , command_component_(
@@ -36,9 +42,16 @@ public:
             Eigen::AngleAxisd{std::numbers::pi, Eigen::Vector3d::UnitZ()});
 
         gimbal_calibrate_subscription_ = create_subscription<std_msgs::msg::Int32>(
-            "/gimbal/calibrate", rclcpp::QoS{0}, [this](std_msgs::msg::Int32::UniquePtr&& msg) {
-                gimbal_calibrate_subscription_callback(std::move(msg));
+            "/gimbal/calibrate", rclcpp::QoS{0}, [this](std_msgs::msg::Int32::UniquePtr&&) {
+                defer([this]() { calibrate_gimbal(); });
             });
+
+        can_report_timer_ = create_wall_timer(std::chrono::seconds(1), [this]() {
+            top_board_.can1_registry_.report_silent_devices(get_logger());
+            top_board_.can2_registry_.report_silent_devices(get_logger());
+            bottom_board_.can1_registry_.report_silent_devices(get_logger());
+            bottom_board_.can2_registry_.report_silent_devices(get_logger());
+        });
     }
 
     ~Hero() override = default;
@@ -54,7 +67,7 @@ public:
     }
 
 private:
-    void gimbal_calibrate_subscription_callback(std_msgs::msg::Int32::UniquePtr) {
+    void calibrate_gimbal() {
         RCLCPP_INFO(
             get_logger(), "[gimbal calibration] New yaw offset: %ld",
             bottom_board_.gimbal_yaw_motor_.calibrate_zero_point());
@@ -65,12 +78,18 @@ private:
 
     OutputInterface<rmcs_description::Tf> tf_;
 
+    // Requested from the ROS spin thread, but deferred to the control thread so as not to race
+    // with the motors.
     rclcpp::Subscription<std_msgs::msg::Int32>::SharedPtr gimbal_calibrate_subscription_;
+    rclcpp::TimerBase::SharedPtr can_report_timer_;
 
     class HeroCommand : public rmcs_executor::Component {
     public:
         explicit HeroCommand(Hero& hero)
-            : hero_(hero) {}
+            : hero_(hero) {
+            // Sends the referee serial, which other components write to.
+            register_shared_state(rmcs_msgs::SerialInterface::shared_state);
+        }
 
         void update() override { hero_.command_update(); }
 
@@ -103,11 +122,27 @@ private:
                    device::DjiMotor::Config{device::DjiMotor::Type::M3508}
                        .set_reduction_ratio(1.)
                        .set_reversed()})
-            , transmit_buffer_(*this, 32)
-            , event_thread_([this]() { handle_events(); }) {
+            , transmit_buffer_(*this, 32) {
 
             hero.register_output("/gimbal/yaw/velocity_imu", gimbal_yaw_velocity_imu_);
             hero.register_output("/gimbal/pitch/velocity_imu", gimbal_pitch_velocity_imu_);
+            bmi088_.register_outputs(hero);
+
+            can1_registry_.register_device(
+                0x201, gimbal_friction_wheels[0], "/gimbal/first_left_friction");
+            can1_registry_.register_device(
+                0x202, gimbal_friction_wheels[1], "/gimbal/second_left_friction");
+            can1_registry_.register_device(
+                0x203, gimbal_friction_wheels[2], "/gimbal/first_right_friction");
+            can1_registry_.register_device(
+                0x204, gimbal_friction_wheels[3], "/gimbal/second_right_friction");
+            can2_registry_.register_device(0x141, gimbal_pitch_motor_, "/gimbal/pitch");
+
+            // Started last, so that frames are only dispatched to registered devices.
+            event_thread_ = std::thread{[this]() {
+                rmcs_executor::trace::set_thread_name("top board usb events");
+                handle_events();
+            }};
         }
 
         ~TopBoard() final {
@@ -140,6 +175,7 @@ private:
 
             transmit_buffer_.add_can2_transmission(0x141, gimbal_pitch_motor_.generate_command());
 
+            rmcs_executor::trace::Scope scope{"trigger_transmission", "usb"};
             transmit_buffer_.trigger_transmission();
         }
 
@@ -147,36 +183,30 @@ private:
         void can1_receive_callback(
             uint32_t can_id, uint64_t can_data, bool is_extended_can_id,
             bool is_remote_transmission, uint8_t can_data_length) override {
+            rmcs_executor::trace::Scope scope{"can1_receive", "usb"};
             if (is_extended_can_id || is_remote_transmission || can_data_length < 8) [[unlikely]]
                 return;
 
-            if (can_id == 0x201) {
-                gimbal_friction_wheels[0].store_status(can_data);
-            } else if (can_id == 0x202) {
-                gimbal_friction_wheels[1].store_status(can_data);
-            } else if (can_id == 0x203) {
-                gimbal_friction_wheels[2].store_status(can_data);
-            } else if (can_id == 0x204) {
-                gimbal_friction_wheels[3].store_status(can_data);
-            }
+            can1_registry_.dispatch(can_id, can_data);
         }
 
         void can2_receive_callback(
             uint32_t can_id, uint64_t can_data, bool is_extended_can_id,
             bool is_remote_transmission, uint8_t can_data_length) override {
+            rmcs_executor::trace::Scope scope{"can2_receive", "usb"};
             if (is_extended_can_id || is_remote_transmission || can_data_length < 8) [[unlikely]]
                 return;
 
-            if (can_id == 0x141) {
-                gimbal_pitch_motor_.store_status(can_data);
-            }
+            can2_registry_.dispatch(can_id, can_data);
         }
 
         void accelerometer_receive_callback(int16_t x, int16_t y, int16_t z) override {
+            rmcs_executor::trace::Scope scope{"accelerometer_receive", "usb"};
             bmi088_.store_accelerometer_status(x, y, z);
         }
 
         void gyroscope_receive_callback(int16_t x, int16_t y, int16_t z) override {
+            rmcs_executor::trace::Scope scope{"gyroscope_receive", "usb"};
             bmi088_.store_gyroscope_status(x, y, z);
         }
 
@@ -189,6 +219,9 @@ private:
 
         device::DjiMotor gimbal_friction_wheels[4];
 
+        device::CanRegistry can1_registry_{"top board can1"};
+        device::CanRegistry can2_registry_{"top board can2"};
+
         librmcs::client::CBoard::TransmitBuffer transmit_buffer_;
         std::thread event_thread_;
     } top_board_;
@@ -219,18 +252,33 @@ private:
             , gimbal_bullet_feeder_(
                   hero, hero_command, "/gimbal/bullet_feeder",
                   device::DjiMotor::Config{device::DjiMotor::Type::M3508}.set_reversed())
-            , transmit_buffer_(*this, 32)
-            , event_thread_([this]() { handle_events(); }) {
+            , transmit_buffer_(*this, 32) {
 
             hero.register_output("/referee/serial", referee_serial_);
             referee_serial_->read = [this](std::byte* buffer, size_t size) {
-                return referee_ring_buffer_receive_.pop_front_multi(
-                    [&buffer](std::byte byte) { *buffer++ = byte; }, size);
+                return referee_receive_.read(buffer, size);
             };
             referee_serial_->write = [this](const std::byte* buffer, size_t size) {
                 transmit_buffer_.add_uart1_transmission(buffer, size);
                 return size;
             };
+
+            can1_registry_.register_device(
+                0x201, chassis_wheel_motors_[0], "/chassis/left_front_wheel");
+            can1_registry_.register_device(
+                0x202, chassis_wheel_motors_[1], "/chassis/left_back_wheel");
+            can1_registry_.register_device(
+                0x203, chassis_wheel_motors_[2], "/chassis/right_back_wheel");
+            can1_registry_.register_device(
+                0x204, chassis_wheel_motors_[3], "/chassis/right_front_wheel");
+            can1_registry_.register_device(0x205, gimbal_bullet_feeder_, "/gimbal/bullet_feeder");
+            can2_registry_.register_device(0x141, gimbal_yaw_motor_, "/gimbal/yaw");
+            can2_registry_.register_device(0x300, supercap_, "/chassis/supercap");
+
+            event_thread_ = std::thread{[this]() {
+                rmcs_executor::trace::set_thread_name("bottom board usb events");
+                handle_events();
+            }};
         }
 
         ~BottomBoard() final {
@@ -281,6 +329,7 @@ private:
             batch_commands[3] = supercap_.generate_command();
             transmit_buffer_.add_can2_transmission(0x1FE, std::bit_cast<uint64_t>(batch_commands));
 
+            rmcs_executor::trace::Scope scope{"trigger_transmission", "usb"};
             transmit_buffer_.trigger_transmission();
         }
 
@@ -288,49 +337,40 @@ private:
         void can1_receive_callback(
             uint32_t can_id, uint64_t can_data, bool is_extended_can_id,
             bool is_remote_transmission, uint8_t can_data_length) override {
+            rmcs_executor::trace::Scope scope{"can1_receive", "usb"};
             if (is_extended_can_id || is_remote_transmission || can_data_length < 8) [[unlikely]]
                 return;
 
-            if (can_id == 0x201) {
-                chassis_wheel_motors_[0].store_status(can_data);
-            } else if (can_id == 0x202) {
-                chassis_wheel_motors_[1].store_status(can_data);
-            } else if (can_id == 0x203) {
-                chassis_wheel_motors_[2].store_status(can_data);
-            } else if (can_id == 0x204) {
-                chassis_wheel_motors_[3].store_status(can_data);
-            } else if (can_id == 0x205) {
-                gimbal_bullet_feeder_.store_status(can_data);
-            }
+            can1_registry_.dispatch(can_id, can_data);
         }
 
         void can2_receive_callback(
             uint32_t can_id, uint64_t can_data, bool is_extended_can_id,
             bool is_remote_transmission, uint8_t can_data_length) override {
+            rmcs_executor::trace::Scope scope{"can2_receive", "usb"};
             if (is_extended_can_id || is_remote_transmission || can_data_length < 8) [[unlikely]]
                 return;
 
-            if (can_id == 0x141) {
-                gimbal_yaw_motor_.store_status(can_data);
-            } else if (can_id == 0x300) {
-                supercap_.store_status(can_data);
-            }
+            can2_registry_.dispatch(can_id, can_data);
         }
 
         void uart1_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) override {
-            referee_ring_buffer_receive_.emplace_back_multi(
-                [&uart_data](std::byte* storage) { *storage = *uart_data++; }, uart_data_length);
+            rmcs_executor::trace::Scope scope{"uart1_receive", "usb"};
+            referee_receive_.output().write(uart_data, uart_data_length);
         }
 
         void dbus_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) override {
+            rmcs_executor::trace::Scope scope{"dbus_receive", "usb"};
             dr16_.store_status(uart_data, uart_data_length);
         }
 
         void accelerometer_receive_callback(int16_t x, int16_t y, int16_t z) override {
+            rmcs_executor::trace::Scope scope{"accelerometer_receive", "usb"};
             bmi088_.store_accelerometer_status(x, y, z);
         }
 
         void gyroscope_receive_callback(int16_t x, int16_t y, int16_t z) override {
+            rmcs_executor::trace::Scope scope{"gyroscope_receive", "usb"};
             bmi088_.store_gyroscope_status(x, y, z);
         }
 
@@ -346,10 +386,14 @@ private:
 
         device::DjiMotor gimbal_bullet_feeder_;
 
-        librmcs::utility::RingBuffer<std::byte> referee_ring_buffer_receive_{256};
+        AsyncInput<std::byte, rmcs_executor::mailbox::SpscQueue<std::byte, 256>> referee_receive_;
         OutputInterface<rmcs_msgs::SerialInterface> referee_serial_;
 
         librmcs::client::CBoard::TransmitBuffer transmit_buffer_;
+
+        device::CanRegistry can1_registry_{"bottom board can1"};
+        device::CanRegistry can2_registry_{"bottom board can2"};
+
         std::thread event_thread_;
     } bottom_board_;
 };
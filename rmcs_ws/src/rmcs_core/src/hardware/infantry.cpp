@@ -1,14 +1,17 @@
+#include <chrono>
 #include <memory>
 
 #include <rclcpp/node.hpp>
 #include <rmcs_description/tf_description.hpp>
 #include <rmcs_executor/component.hpp>
+#include <rmcs_executor/trace.hpp>
 #include <rmcs_msgs/serial_interface.hpp>
 #include <std_msgs/msg/int32.hpp>
 
 #include <librmcs/client/cboard.hpp>
 
 #include "hardware/device/bmi088.hpp"
+#include "hardware/device/can_registry.hpp"
 #include "hardware/device/dji_motor.hpp"
 #include "hardware/device/dr16.hpp"
 #include "hardware/device/supercap.hpp"
@@ -20,14 +23,16 @@ class Infantry
     , public rclcpp::Node
     , private librmcs::client::CBoard {
 public:
+    using rclcpp::Node::get_logger;
+    using rclcpp::Node::get_parameter;
+
     Infantry()
         : Node{get_component_name(), rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)}
         , librmcs::client::CBoard{static_cast<int>(get_parameter("usb_pid").as_int())}
         , logger_(get_logger())
         , infantry_command_(
               create_partner_component<InfantryCommand>(get_component_name() + "_command", *this))
-        , transmit_buffer_(*this, 32)
-        , event_thread_([this]() { handle_events(); }) {
+        , transmit_buffer_(*this, 32) {
 
         for (auto& motor : chassis_wheel_motors_)
             motor.configure(
@@ -56,6 +61,7 @@ public:
 
         register_output("/gimbal/yaw/velocity_imu", gimbal_yaw_velocity_imu_);
         register_output("/gimbal/pitch/velocity_imu", gimbal_pitch_velocity_imu_);
+        imu_.register_outputs(*this);
         register_output("/tf", tf_);
 
         using namespace rmcs_description;
@@ -77,19 +83,45 @@ public:
             Eigen::Translation3d{wheel_distance_x / 2, -wheel_distance_y / 2, 0});
 
         gimbal_calibrate_subscription_ = create_subscription<std_msgs::msg::Int32>(
-            "/gimbal/calibrate", rclcpp::QoS{0}, [this](std_msgs::msg::Int32::UniquePtr&& msg) {
-                gimbal_calibrate_subscription_callback(std::move(msg));
+            "/gimbal/calibrate", rclcpp::QoS{0}, [this](std_msgs::msg::Int32::UniquePtr&&) {
+                defer([this]() { calibrate_gimbal(); });
             });
 
         register_output("/referee/serial", referee_serial_);
         referee_serial_->read = [this](std::byte* buffer, size_t size) {
-            return referee_ring_buffer_receive_.pop_front_multi(
-                [&buffer](std::byte byte) { *buffer++ = byte; }, size);
+            return referee_receive_.read(buffer, size);
         };
         referee_serial_->write = [this](const std::byte* buffer, size_t size) {
             transmit_buffer_.add_uart1_transmission(buffer, size);
             return size;
         };
+
+        can1_registry_.register_device(
+            0x201, chassis_wheel_motors_[0], "/chassis/left_front_wheel");
+        can1_registry_.register_device(
+            0x202, chassis_wheel_motors_[1], "/chassis/right_front_wheel");
+        can1_registry_.register_device(
+            0x203, chassis_wheel_motors_[2], "/chassis/right_back_wheel");
+        can1_registry_.register_device(
+            0x204, chassis_wheel_motors_[3], "/chassis/left_back_wheel");
+        can1_registry_.register_device(0x205, gimbal_yaw_motor_, "/gimbal/yaw");
+        can1_registry_.register_device(0x300, supercap_, "/chassis/supercap");
+        can2_registry_.register_device(0x202, gimbal_bullet_feeder_, "/gimbal/bullet_feeder");
+        can2_registry_.register_device(0x203, gimbal_left_friction_, "/gimbal/left_friction");
+        can2_registry_.register_device(0x204, gimbal_right_friction_, "/gimbal/right_friction");
+        // The pitch motor is wired to either bus, so one of them always stays silent.
+        can1_registry_.register_device(0x206, gimbal_pitch_motor_, "/gimbal/pitch", true);
+        can2_registry_.register_device(0x206, gimbal_pitch_motor_, "/gimbal/pitch", true);
+
+        can_report_timer_ = create_wall_timer(std::chrono::seconds(1), [this]() {
+            device::CanRegistry::report_silent_devices(logger_, {&can1_registry_, &can2_registry_});
+        });
+
+        // Started last, so that frames are only dispatched to registered devices.
+        event_thread_ = std::thread{[this]() {
+            rmcs_executor::trace::set_thread_name(get_component_name() + " usb events");
+            handle_events();
+        }};
     }
 
     ~Infantry() override {
@@ -131,6 +163,7 @@ public:
         can_commands[3] = gimbal_right_friction_.generate_command();
         transmit_buffer_.add_can2_transmission(0x200, std::bit_cast<uint64_t>(can_commands));
 
+        rmcs_executor::trace::Scope scope{"trigger_transmission", "usb"};
         transmit_buffer_.trigger_transmission();
     }
 
@@ -164,7 +197,7 @@ private:
         *gimbal_pitch_velocity_imu_ = imu_.gx();
     }
 
-    void gimbal_calibrate_subscription_callback(std_msgs::msg::Int32::UniquePtr) {
+    void calibrate_gimbal() {
         RCLCPP_INFO(
             logger_, "[gimbal calibration] New yaw offset: %d",
             gimbal_yaw_motor_.calibrate_zero_point());
@@ -177,61 +210,40 @@ protected:
     void can1_receive_callback(
         uint32_t can_id, uint64_t can_data, bool is_extended_can_id, bool is_remote_transmission,
         uint8_t can_data_length) override {
+        rmcs_executor::trace::Scope scope{"can1_receive", "usb"};
         if (is_extended_can_id || is_remote_transmission || can_data_length < 8) [[unlikely]]
             return;
 
-        if (can_id == 0x201) {
-            auto& motor = chassis_wheel_motors_[0];
-            motor.store_status(can_data);
-        } else if (can_id == 0x202) {
-            auto& motor = chassis_wheel_motors_[1];
-            motor.store_status(can_data);
-        } else if (can_id == 0x203) {
-            auto& motor = chassis_wheel_motors_[2];
-            motor.store_status(can_data);
-        } else if (can_id == 0x204) {
-            auto& motor = chassis_wheel_motors_[3];
-            motor.store_status(can_data);
-        } else if (can_id == 0x205) {
-            gimbal_yaw_motor_.store_status(can_data);
-        } else if (can_id == 0x206) {
-            gimbal_pitch_motor_.store_status(can_data);
-        } else if (can_id == 0x300) {
-            supercap_.store_status(can_data);
-        }
+        can1_registry_.dispatch(can_id, can_data);
     }
 
     void can2_receive_callback(
         uint32_t can_id, uint64_t can_data, bool is_extended_can_id, bool is_remote_transmission,
         uint8_t can_data_length) override {
+        rmcs_executor::trace::Scope scope{"can2_receive", "usb"};
         if (is_extended_can_id || is_remote_transmission || can_data_length < 8) [[unlikely]]
             return;
 
-        if (can_id == 0x202) {
-            gimbal_bullet_feeder_.store_status(can_data);
-        } else if (can_id == 0x203) {
-            gimbal_left_friction_.store_status(can_data);
-        } else if (can_id == 0x204) {
-            gimbal_right_friction_.store_status(can_data);
-        } else if (can_id == 0x206) {
-            gimbal_pitch_motor_.store_status(can_data);
-        }
+        can2_registry_.dispatch(can_id, can_data);
     }
 
     void uart1_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) override {
-        referee_ring_buffer_receive_.emplace_back_multi(
-            [&uart_data](std::byte* storage) { *storage = *uart_data++; }, uart_data_length);
+        rmcs_executor::trace::Scope scope{"uart1_receive", "usb"};
+        referee_receive_.output().write(uart_data, uart_data_length);
     }
 
     void dbus_receive_callback(const std::byte* uart_data, uint8_t uart_data_length) override {
+        rmcs_executor::trace::Scope scope{"dbus_receive", "usb"};
         dr16_.store_status(uart_data, uart_data_length);
     }
 
     void accelerometer_receive_callback(int16_t x, int16_t y, int16_t z) override {
+        rmcs_executor::trace::Scope scope{"accelerometer_receive", "usb"};
         imu_.store_accelerometer_status(x, y, z);
     }
 
     void gyroscope_receive_callback(int16_t x, int16_t y, int16_t z) override {
+        rmcs_executor::trace::Scope scope{"gyroscope_receive", "usb"};
         imu_.store_gyroscope_status(x, y, z);
     }
 
@@ -241,7 +253,10 @@ private:
     class InfantryCommand : public rmcs_executor::Component {
     public:
         explicit InfantryCommand(Infantry& infantry)
-            : infantry_(infantry) {}
+            : infantry_(infantry) {
+            // Sends the referee serial, which other components write to.
+            register_shared_state(rmcs_msgs::SerialInterface::shared_state);
+        }
 
         void update() override { infantry_.command_update(); }
 
@@ -249,6 +264,8 @@ private:
     };
     std::shared_ptr<InfantryCommand> infantry_command_;
 
+    // Requested from the ROS spin thread, but deferred to the control thread so as not to race
+    // with the motors.
     rclcpp::Subscription<std_msgs::msg::Int32>::SharedPtr gimbal_calibrate_subscription_;
 
     device::DjiMotor chassis_wheel_motors_[4]{
@@ -275,11 +292,14 @@ private:
 
     OutputInterface<rmcs_description::Tf> tf_;
 
-    librmcs::utility::RingBuffer<std::byte> referee_ring_buffer_receive_{256};
+    AsyncInput<std::byte, rmcs_executor::mailbox::SpscQueue<std::byte, 256>> referee_receive_;
     OutputInterface<rmcs_msgs::SerialInterface> referee_serial_;
 
     librmcs::client::CBoard::TransmitBuffer transmit_buffer_;
 
+    device::CanRegistry can1_registry_{"can1"}, can2_registry_{"can2"};
+    rclcpp::TimerBase::SharedPtr can_report_timer_;
+
     std::thread event_thread_;
 };
 
@@ -3,7 +3,6 @@
 #include <cstdint>
 
 #include <game_stage.hpp>
-#include <rclcpp/node.hpp>
 #include <rmcs_executor/component.hpp>
 #include <rmcs_msgs/chassis_mode.hpp>
 #include <rmcs_msgs/mouse.hpp>
@@ -15,13 +14,10 @@
 namespace rmcs_core::referee::app::ui {
 using namespace std::chrono_literals;
 
-class Hero
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class Hero : public rmcs_executor::Component {
 public:
     Hero()
-        : Node{get_component_name(), rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)}
-        , crosshair_(Shape::Color::WHITE, x_center - 12, y_center - 37)
+        : crosshair_(Shape::Color::WHITE, x_center - 12, y_center - 37)
         , status_ring_()
         , horizontal_center_guidelines_(
               {Shape::Color::WHITE, 2, x_center - 360, y_center, x_center - 110, y_center},
@@ -69,6 +65,11 @@ public:
 
         register_input("/referee/game/stage", game_stage_);
 
+        register_shared_state(command::field_shared_state);
+
+        // Shapes are sent at no more than 25Hz, updating them faster is wasted work.
+        set_update_period(40ms);
+
         // register_input("/auto_aim/ui_target", auto_aim_target_, false);
     }
 
@@ -1,6 +1,5 @@
 #include <chrono>
 
-#include <rclcpp/node.hpp>
 #include <rmcs_executor/component.hpp>
 #include <serial_interface.hpp>
 #include <serial_util/crc/dji_crc.hpp>
@@ -11,22 +10,23 @@
 namespace rmcs_core::referee {
 using namespace command;
 
-class Command
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class Command : public rmcs_executor::Component {
 public:
     Command()
-        : Node{get_component_name(), rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)}
-        , next_sent_(std::chrono::steady_clock::time_point::min())
+        : next_sent_(std::chrono::steady_clock::time_point::min())
         , interaction_next_sent_(std::chrono::steady_clock::time_point::min())
         , map_marker_next_sent_(std::chrono::steady_clock::time_point::min())
         , text_display_next_sent_(std::chrono::steady_clock::time_point::min()) {
 
+        register_input("/predefined/timestamp", timestamp_);
         register_input("/referee/serial", serial_, false);
 
         register_input("/referee/command/interaction", interaction_field_, false);
         register_input("/referee/command/map_marker", map_marker_field_, false);
         register_input("/referee/command/text_display", text_display_field_, false);
+
+        register_shared_state(field_shared_state);
+        register_shared_state(rmcs_msgs::SerialInterface::shared_state);
     }
 
     void before_updating() override {
@@ -43,7 +43,7 @@ public:
             return;
 
         using namespace std::chrono_literals;
-        auto now     = std::chrono::steady_clock::now();
+        auto now     = *timestamp_;
         auto& serial = const_cast<rmcs_msgs::SerialInterface&>(*serial_);
 
         if (now < next_sent_)
@@ -83,6 +83,7 @@ public:
     }
 
 private:
+    InputInterface<std::chrono::steady_clock::time_point> timestamp_;
     InputInterface<rmcs_msgs::SerialInterface> serial_;
     Frame frame_;
 
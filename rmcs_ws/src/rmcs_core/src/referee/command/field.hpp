@@ -39,6 +39,10 @@ private:
     size_t (*write_)(const intptr_t&, std::byte*);
 };
 
+// Fields are written lazily by referee::Command, so whatever a field touches while being written is
+// shared with it. Components producing or feeding such fields register this key as shared state.
+inline constexpr char field_shared_state[] = "rmcs_core::referee::command::Field";
+
 inline size_t write_field(std::byte*) { return 0; }
 
 template <typename... Ts>
@@ -1,18 +1,12 @@
-#include <rclcpp/node.hpp>
 #include <rmcs_executor/component.hpp>
 
 #include "referee/command/field.hpp"
 
 namespace rmcs_core::referee::command {
 
-class Interaction
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class Interaction : public rmcs_executor::Component {
 public:
-    Interaction()
-        : Node{
-              get_component_name(),
-              rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)} {
+    Interaction() {
 
         register_input(
             "/referee/command/interaction/sentry_decision", sentry_decision_field_, false);
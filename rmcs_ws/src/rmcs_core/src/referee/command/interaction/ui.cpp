@@ -1,6 +1,5 @@
 #include <algorithm>
 
-#include <rclcpp/node.hpp>
 #include <rmcs_executor/component.hpp>
 #include <rmcs_msgs/full_robot_id.hpp>
 #include <rmcs_msgs/game_stage.hpp>
@@ -14,20 +13,17 @@
 namespace rmcs_core::referee::command::interaction {
 using namespace app::ui;
 
-class Ui
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class Ui : public rmcs_executor::Component {
 public:
-    Ui()
-        : Node{
-              get_component_name(),
-              rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)} {
+    Ui() {
 
         register_input("/referee/id", robot_id_);
         register_input("/referee/game/stage", game_stage_);
         register_input("/remote/keyboard", keyboard_);
 
         register_output("/referee/command/interaction/ui", ui_field_);
+
+        register_shared_state(field_shared_state);
     }
 
     void update() override {
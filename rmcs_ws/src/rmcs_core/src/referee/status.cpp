@@ -1,5 +1,4 @@
 #include <eigen3/Eigen/Eigen>
-#include <rclcpp/node.hpp>
 
 #include <rmcs_executor/component.hpp>
 #include <rmcs_msgs/game_stage.hpp>
@@ -14,13 +13,10 @@
 namespace rmcs_core::referee {
 using namespace status;
 
-class Status
-    : public rmcs_executor::Component
-    , public rclcpp::Node {
+class Status : public rmcs_executor::Component {
 public:
     Status()
-        : Node{get_component_name(), rclcpp::NodeOptions{}.automatically_declare_parameters_from_overrides(true)}
-        , logger_(get_logger()) {
+        : logger_(get_logger()) {
         register_input("/referee/serial", serial_);
 
         register_output("/referee/game/stage", game_stage_, rmcs_msgs::GameStage::UNKNOWN);
@@ -2,6 +2,7 @@
 
 #include <fast_tf/fast_tf.hpp>
 #include <fast_tf/impl/link.hpp>
+#include <rmcs_executor/byte_copyable.hpp>
 
 namespace rmcs_description {
 
@@ -195,3 +196,7 @@ using Tf = fast_tf::JointCollection<
     OmniLinkLeftFront, OmniLinkRightFront, OmniLinkLeft, OmniLinkRight>;
 
 } // namespace rmcs_description
+
+// Joints only hold fixed-size Eigen transforms, so the tree can be recorded and exported as is.
+template <>
+struct rmcs_executor::is_byte_copyable<rmcs_description::Tf> : std::true_type {};
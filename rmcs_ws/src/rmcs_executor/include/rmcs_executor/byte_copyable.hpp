@@ -0,0 +1,55 @@
+#pragma once
+
+#include <type_traits>
+
+// Declared here so that the specializations below need no dependency on Eigen. They match the
+// declarations of Eigen/src/Core/util/ForwardDeclarations.h, which carry the default arguments.
+namespace Eigen {
+template <typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+class Matrix;
+template <typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+class Array;
+template <typename Scalar, int Options>
+class Quaternion;
+template <typename Scalar>
+class AngleAxis;
+template <typename Scalar, int Dim>
+class Translation;
+template <typename Scalar, int Dim, int Mode, int Options>
+class Transform;
+} // namespace Eigen
+
+namespace rmcs_executor {
+
+// Whether the bytes of a value are the whole value, so that it can be recorded to a data log or
+// exported to shared memory, and restored with memcpy. Types that hold no pointer, but are not
+// trivially copyable because of user-provided copy operations, may specialize it.
+template <typename T>
+struct is_byte_copyable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+constexpr bool is_byte_copyable_v = is_byte_copyable<T>::value;
+
+// Fixed-size Eigen types store their coefficients inline. Dynamic sizes are -1 (Eigen::Dynamic).
+template <typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct is_byte_copyable<Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols>>
+    : std::bool_constant<Rows != -1 && Cols != -1 && is_byte_copyable_v<Scalar>> {};
+
+template <typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct is_byte_copyable<Eigen::Array<Scalar, Rows, Cols, Options, MaxRows, MaxCols>>
+    : std::bool_constant<Rows != -1 && Cols != -1 && is_byte_copyable_v<Scalar>> {};
+
+template <typename Scalar, int Options>
+struct is_byte_copyable<Eigen::Quaternion<Scalar, Options>> : is_byte_copyable<Scalar> {};
+
+template <typename Scalar>
+struct is_byte_copyable<Eigen::AngleAxis<Scalar>> : is_byte_copyable<Scalar> {};
+
+template <typename Scalar, int Dim>
+struct is_byte_copyable<Eigen::Translation<Scalar, Dim>> : is_byte_copyable<Scalar> {};
+
+template <typename Scalar, int Dim, int Mode, int Options>
+struct is_byte_copyable<Eigen::Transform<Scalar, Dim, Mode, Options>>
+    : std::bool_constant<Dim != -1 && is_byte_copyable_v<Scalar>> {};
+
+} // namespace rmcs_executor
\ No newline at end of file
@@ -1,20 +1,35 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <typeinfo>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <rclcpp/exceptions.hpp>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/parameter.hpp>
+#include <rclcpp/parameter_map.hpp>
+
+#include "rmcs_executor/byte_copyable.hpp"
+#include "rmcs_executor/mailbox.hpp"
+
 namespace rmcs_executor {
 
 class Component {
 public:
     friend class Executor;
+    friend struct UpdateEntry;
 
     Component(const Component&)            = delete;
     Component& operator=(const Component&) = delete;
@@ -30,6 +45,13 @@ public:
 
     virtual void update() = 0;
 
+    // Kept next to every output and visible to its consumers.
+    struct OutputMetadata {
+        size_t version  = 0; // Bumped on every non-const access to the value, or changing set()
+        size_t sequence = 0; // Bumped on every stamp by the producer
+        std::chrono::steady_clock::time_point timestamp{};
+    };
+
     template <typename T>
     requires(!std::is_reference_v<T> && !std::is_unbounded_array_v<T>) class InputInterface {
     public:
@@ -77,14 +99,26 @@ public:
         const T* operator->() const { return data_pointer_; }
         const T& operator*() const { return *data_pointer_; }
 
+        // When the producer last stamped the value, or the epoch if it never did (as for inputs
+        // bound directly).
+        [[nodiscard]] std::chrono::steady_clock::time_point timestamp() const {
+            return metadata_->timestamp;
+        }
+        [[nodiscard]] std::chrono::steady_clock::duration
+            age(std::chrono::steady_clock::time_point now) const {
+            return now - metadata_->timestamp;
+        }
+        [[nodiscard]] size_t sequence() const { return metadata_->sequence; }
+
     private:
         void** activate() {
             activated = true;
             return reinterpret_cast<void**>(&data_pointer_);
         }
 
-        T* data_pointer_ = nullptr;
-        bool activated   = false;
+        T* data_pointer_                 = nullptr;
+        const OutputMetadata* metadata_ = &unbound_metadata_;
+        bool activated                  = false;
 
         bool delete_data_when_deconstruct = false;
     };
@@ -103,46 +137,206 @@ public:
 
         ~OutputInterface() {
             if (active())
-                std::destroy_at(std::launder(reinterpret_cast<T*>(&data_)));
+                std::destroy_at(data_pointer_);
         };
 
         [[nodiscard]] bool active() const { return activated; }
 
-        T* operator->() { return reinterpret_cast<T*>(&data_); }
-        const T* operator->() const { return reinterpret_cast<const T*>(&data_); }
-        T& operator*() { return *reinterpret_cast<T*>(&data_); }
-        const T& operator*() const { return *reinterpret_cast<const T*>(&data_); }
+        // Non-const access counts as a write, which is what lazily updated consumers and partition
+        // channels look at.
+        T* operator->() {
+            metadata_.version++;
+            return data_pointer_;
+        }
+        const T* operator->() const { return data_pointer_; }
+        T& operator*() {
+            metadata_.version++;
+            return *data_pointer_;
+        }
+        const T& operator*() const { return *data_pointer_; }
+
+        // Writes without counting as a write when the value stays the same, so that lazily updated
+        // consumers of event-like values (e.g. the switches of the remote) are skipped, and the
+        // value is not handed over to other partitions again, until it changes. Returns whether it
+        // changed.
+        template <typename U>
+        requires std::equality_comparable_with<T, U> bool set(U&& value) {
+            if (*data_pointer_ == value)
+                return false;
+            *data_pointer_ = std::forward<U>(value);
+            metadata_.version++;
+            return true;
+        }
+
+        // Records when the value was produced, e.g. when the feedback it comes from was received,
+        // in tick time (/predefined/timestamp) so that it compares with a simulated clock too.
+        // Consumers may pass the timestamp of their inputs on to propagate it.
+        void stamp(std::chrono::steady_clock::time_point timestamp) {
+            metadata_.timestamp = timestamp;
+            metadata_.sequence++;
+        }
+        const OutputMetadata& metadata() const { return metadata_; }
 
     private:
         template <typename... Args>
         void* activate(Args&&... args) {
-            ::new (&data_) T(std::forward<Args>(args)...);
-            activated = true;
-            return reinterpret_cast<void*>(&data_);
+            data_pointer_ = ::new (&data_) T(std::forward<Args>(args)...);
+            activated     = true;
+            return data_pointer_;
         }
 
+        // The value is constructed in place first, and may be moved into the output arena of the
+        // executor during initialization.
+        static void* relocate(void* interface, void* destination) {
+            auto& self         = *static_cast<OutputInterface*>(interface);
+            auto new_pointer   = ::new (destination) T(std::move(*self.data_pointer_));
+            std::destroy_at(self.data_pointer_);
+            self.data_pointer_ = new_pointer;
+            return new_pointer;
+        }
+
+        // Values handed over to other partitions are copied through these.
+        static void copy_construct(void* destination, const void* source) {
+            ::new (destination) T(*static_cast<const T*>(source));
+        }
+        static void copy_assign(void* destination, const void* source) {
+            *static_cast<T*>(destination) = *static_cast<const T*>(source);
+        }
+        static void destroy(void* value) { std::destroy_at(static_cast<T*>(value)); }
+
         std::aligned_storage_t<sizeof(T), alignof(T)> data_;
+        T* data_pointer_ = nullptr;
+        OutputMetadata metadata_;
         bool activated = false;
     };
 
+    // Producer side of an AsyncInput, the only part that may be used outside of the control thread.
+    template <typename T, typename Mailbox = mailbox::SeqLock<T>>
+    class MailboxOutput {
+    public:
+        template <typename... Args>
+        decltype(auto) write(Args&&... args) {
+            return mailbox_.write(std::forward<Args>(args)...);
+        }
+
+    protected:
+        MailboxOutput() = default;
+        template <typename... Args>
+        explicit MailboxOutput(Args&&... args)
+            : mailbox_(std::forward<Args>(args)...) {}
+
+        Mailbox mailbox_;
+    };
+
+    // Data produced asynchronously (by the event thread of a board, a ROS callback) for update().
+    // The producer only gets `output()`, and `read()` only happens in update(), so that state
+    // shared with other threads never needs a lock. See rmcs_executor/mailbox.hpp for the policies.
+    template <typename T, typename Mailbox = mailbox::SeqLock<T>>
+    class AsyncInput : private MailboxOutput<T, Mailbox> {
+    public:
+        AsyncInput() = default;
+        template <typename... Args>
+        explicit AsyncInput(Args&&... args)
+            : MailboxOutput<T, Mailbox>(std::forward<Args>(args)...) {}
+
+        AsyncInput(const AsyncInput&)            = delete;
+        AsyncInput& operator=(const AsyncInput&) = delete;
+        AsyncInput(AsyncInput&&)                 = delete;
+        AsyncInput& operator=(AsyncInput&&)      = delete;
+
+        MailboxOutput<T, Mailbox>& output() { return *this; }
+
+        template <typename... Args>
+        decltype(auto) read(Args&&... args) {
+            return this->mailbox_.read(std::forward<Args>(args)...);
+        }
+    };
+
     const std::string& get_component_name() { return component_name_; }
 
+    // Parameters of the section named after the component in the parameter files (or given with
+    // `-p`), read through the executor, so that components need no rclcpp::Node of their own. They
+    // behave like their counterparts of rclcpp::Node, which components deriving from both should
+    // bring in with `using rclcpp::Node::get_parameter;`.
+    rclcpp::Parameter get_parameter(const std::string& name) const {
+        auto parameter = find_parameter(name);
+        if (!parameter)
+            throw rclcpp::exceptions::ParameterNotDeclaredException{name};
+        return *parameter;
+    }
+
+    template <typename T>
+    bool get_parameter(const std::string& name, T& value) const {
+        auto parameter = find_parameter(name);
+        if (!parameter)
+            return false;
+        value = static_cast<T>(parameter->get_value<T>());
+        return true;
+    }
+
+    bool has_parameter(const std::string& name) const { return find_parameter(name) != nullptr; }
+
+    rclcpp::Logger get_logger() const { return rclcpp::get_logger(component_name_); }
+
     template <typename T>
     void register_input(
         const std::string& name, InputInterface<T>& interface, bool required = true) {
         if (interface.active())
             throw std::runtime_error("The interface has been activated");
-        input_list_.emplace_back(typeid(T), name, required, interface.activate());
+        input_list_.emplace_back(
+            typeid(T), name, required, interface.activate(), &interface.metadata_);
     }
 
     template <typename T, typename... Args>
     void register_output(const std::string& name, OutputInterface<T>& interface, Args&&... args) {
         if (interface.active())
             throw std::runtime_error("The interface has been activated");
-        output_list_.emplace_back(
-            typeid(T), name, interface.activate(std::forward<Args>(args)...), this);
+        auto& output = output_list_.emplace_back(
+            typeid(T), name, interface.activate(std::forward<Args>(args)...), this, sizeof(T),
+            alignof(T), is_byte_copyable_v<T>);
+        output.interface = &interface;
+        output.metadata  = &interface.metadata_;
+        if constexpr (std::is_nothrow_move_constructible_v<T>)
+            output.relocate = &OutputInterface<T>::relocate;
+        if constexpr (std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>) {
+            output.copy_construct = &OutputInterface<T>::copy_construct;
+            output.copy_assign    = &OutputInterface<T>::copy_assign;
+            output.destroy        = &OutputInterface<T>::destroy;
+        }
+    }
+
+    // Asks the executor to update this component only once every `divisor` ticks.
+    void set_update_divisor(size_t divisor) { update_divisor_ = divisor; }
+
+    // Same as set_update_divisor, with the divisor derived from the update rate of the executor.
+    template <typename Rep, typename Period>
+    void set_update_period(std::chrono::duration<Rep, Period> period) {
+        update_period_ = std::chrono::duration_cast<std::chrono::nanoseconds>(period);
+    }
+
+    // Lets the executor skip update() as long as no output bound to an input of this component has
+    // been written since the last update. Only for components whose outputs are a pure function of
+    // their inputs. Inputs bound directly are considered constant.
+    void enable_lazy_update() { lazy_update_ = true; }
+
+    // Keeps the component (and everything it depends on) from being pruned even if none of its
+    // outputs are consumed, typically because it has side effects.
+    void mark_as_sink() { is_sink_ = true; }
+
+    // Runs `callback` on the thread updating this component, right before its next update(), so
+    // that callbacks of other threads (ROS subscriptions, services) can change the state of the
+    // component without locks. May be called from any thread.
+    template <typename F>
+    void defer(F&& callback) {
+        std::lock_guard guard{deferred_mutex_};
+        deferred_callbacks_.emplace_back(std::forward<F>(callback));
+        deferred_pending_.store(true, std::memory_order::release);
     }
 
+    // Components touching the same state outside of their inputs and outputs (e.g. a static
+    // scheduler) must register the same key, so that they are never updated concurrently.
+    void register_shared_state(const std::string& key) { shared_state_list_.emplace_back(key); }
+
     template <typename T, typename... Args>
     std::shared_ptr<T> create_partner_component(const std::string& name, Args&&... args) {
         initializing_component_name = name.c_str();
@@ -160,6 +354,27 @@ protected:
         : component_name_(initializing_component_name) {}
 
 private:
+    static const OutputMetadata unbound_metadata_;
+
+    // Parameters given to the process by fully qualified node name, set by the executor before
+    // components are constructed. Parameters of "/**" apply to every component.
+    static rclcpp::ParameterMap parameter_map_;
+
+    const rclcpp::Parameter* find_parameter(const std::string& name) const {
+        auto search = [&name](const std::string& node_name) -> const rclcpp::Parameter* {
+            auto iter = parameter_map_.find(node_name);
+            if (iter == parameter_map_.end())
+                return nullptr;
+            for (const auto& parameter : iter->second) {
+                if (parameter.get_name() == name)
+                    return &parameter;
+            }
+            return nullptr;
+        };
+        auto parameter = search("/" + component_name_);
+        return parameter ? parameter : search("/**");
+    }
+
     std::string component_name_;
 
     struct InputDeclaration {
@@ -167,6 +382,7 @@ private:
         std::string name;
         bool required;
         void** pointer_to_data_pointer;
+        const OutputMetadata** pointer_to_metadata_pointer;
     };
 
     struct OutputDeclaration {
@@ -175,6 +391,18 @@ private:
         void* data_pointer;
 
         Component* component;
+
+        size_t size, alignment;
+        bool byte_copyable; // See rmcs_executor/byte_copyable.hpp
+
+        // Null when the type does not support the operation.
+        void* (*relocate)(void* interface, void* destination)          = nullptr;
+        void (*copy_construct)(void* destination, const void* source) = nullptr;
+        void (*copy_assign)(void* destination, const void* source)    = nullptr;
+        void (*destroy)(void* value)                                   = nullptr;
+        void* interface                                                = nullptr;
+
+        const OutputMetadata* metadata = nullptr;
     };
 
     std::vector<InputDeclaration> input_list_;
@@ -182,8 +410,45 @@ private:
 
     std::vector<std::shared_ptr<Component>> partner_component_list_;
 
+    // Keeps the output arena alive until the outputs placed there are destroyed.
+    std::shared_ptr<void> output_arena_;
+
+    std::vector<std::string> shared_state_list_;
+
+    bool is_sink_     = false;
+    bool lazy_update_ = false;
+
+    // Versions of the outputs bound to the inputs, filled by the executor.
+    std::vector<const size_t*> input_versions_;
+
+    size_t update_divisor_                  = 1;
+    std::chrono::nanoseconds update_period_ = std::chrono::nanoseconds::zero();
+
     size_t dependency_count_                  = 0;
     std::unordered_set<Component*> wanted_by_ = {};
+
+    // The updating thread never waits for the lock: if a producer holds it, deferred callbacks
+    // simply run before the following update.
+    void run_deferred_callbacks() {
+        if (!deferred_pending_.load(std::memory_order::acquire))
+            return;
+        {
+            std::unique_lock lock{deferred_mutex_, std::try_to_lock};
+            if (!lock.owns_lock())
+                return;
+            running_callbacks_.swap(deferred_callbacks_);
+            deferred_pending_.store(false, std::memory_order::relaxed);
+        }
+        for (auto& callback : running_callbacks_)
+            callback();
+        running_callbacks_.clear();
+    }
+
+    std::mutex deferred_mutex_;
+    std::vector<std::function<void()>> deferred_callbacks_, running_callbacks_;
+    std::atomic<bool> deferred_pending_ = false;
 };
 
+inline const Component::OutputMetadata Component::unbound_metadata_{};
+
 } // namespace rmcs_executor
\ No newline at end of file
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+namespace rmcs_executor::mailbox {
+
+// Lock-free handoff from a thread other than the control thread (the event thread of a board, a
+// ROS callback) to update(). Every policy offers `write` to the producer and `read` to the
+// consumer, and the reader never waits for the producer: it may run at a higher priority on the
+// same cpu, where waiting for a preempted producer would never end.
+
+constexpr size_t cache_line_size = 64;
+
+// Latest value, read as a consistent snapshot of all its fields. Cheapest for small values written
+// often. A read retries a bounded number of times while it overlaps a write, then falls back to the
+// previous snapshot. With `multi_producer`, concurrent writers are serialized by a spinlock among
+// themselves only.
+template <typename T, bool multi_producer = false>
+requires std::is_trivially_copyable_v<T> class SeqLock {
+public:
+    SeqLock() { store_words(last_read_); }
+    explicit SeqLock(const T& initial)
+        : last_read_(initial) {
+        store_words(initial);
+    }
+
+    void write(const T& value) {
+        if constexpr (multi_producer) {
+            while (writing_.test_and_set(std::memory_order::acquire))
+                while (writing_.test(std::memory_order::relaxed))
+                    ;
+        }
+
+        auto sequence = sequence_.load(std::memory_order::relaxed);
+        sequence_.store(sequence + 1, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::release);
+        store_words(value);
+        sequence_.store(sequence + 2, std::memory_order::release);
+
+        if constexpr (multi_producer)
+            writing_.clear(std::memory_order::release);
+    }
+
+    // For a single reader. A write in progress for all the attempts means its producer is stalled,
+    // e.g. preempted by the reader itself, so the previous snapshot is as recent as it gets.
+    T read(size_t max_attempts = 64) {
+        if (auto value = try_read(max_attempts))
+            last_read_ = *value;
+        return last_read_;
+    }
+
+    // Returns nullopt if every attempt overlapped a write.
+    std::optional<T> try_read(size_t max_attempts = 64) const {
+        T value;
+        for (size_t i = 0; i < max_attempts; i++) {
+            auto begin = sequence_.load(std::memory_order::acquire);
+            if (begin & 1)
+                continue;
+            load_words(value);
+            std::atomic_thread_fence(std::memory_order::acquire);
+            if (sequence_.load(std::memory_order::relaxed) == begin)
+                return value;
+        }
+        return std::nullopt;
+    }
+
+    // Number of writes so far.
+    size_t version() const { return sequence_.load(std::memory_order::acquire) / 2; }
+
+private:
+    static constexpr size_t word_count = (sizeof(T) + 7) / 8;
+
+    // Word-sized relaxed atomics make a torn read a detectable retry rather than a data race.
+    void store_words(const T& value) {
+        uint64_t words[word_count] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < word_count; i++)
+            std::atomic_ref<uint64_t>{words_[i]}.store(words[i], std::memory_order::relaxed);
+    }
+
+    void load_words(T& value) const {
+        uint64_t words[word_count];
+        for (size_t i = 0; i < word_count; i++)
+            words[i] = std::atomic_ref<uint64_t>{const_cast<uint64_t&>(words_[i])}.load(
+                std::memory_order::relaxed);
+        std::memcpy(&value, words, sizeof(T));
+    }
+
+    alignas(cache_line_size) std::atomic<size_t> sequence_ = 0;
+    alignas(8) uint64_t words_[word_count];
+
+    std::atomic_flag writing_ = ATOMIC_FLAG_INIT;
+
+    // Reader side.
+    alignas(cache_line_size) T last_read_{};
+};
+
+// Latest value, for a single producer. Unlike SeqLock, the reader neither copies nor retries: it
+// swaps in the most recently completed buffer and gets a reference to it, which suits large values
+// or values that are not trivially copyable.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T& initial)
+        : buffers_{initial, initial, initial} {}
+
+    void write(const T& value) {
+        buffers_[back_].value = value;
+        publish();
+    }
+
+    // Lets the producer fill the back buffer in place, then publishes it.
+    template <typename F>
+    requires std::is_invocable_v<F, T&> void write_in_place(F&& fill) {
+        fill(buffers_[back_].value);
+        publish();
+    }
+
+    // The reference stays valid, and unchanged, until the next read.
+    const T& read() {
+        if (middle_.load(std::memory_order::relaxed) & dirty_bit)
+            front_ = middle_.exchange(front_, std::memory_order::acq_rel) & index_mask;
+        return buffers_[front_].value;
+    }
+
+private:
+    static constexpr uint8_t index_mask = 0b011, dirty_bit = 0b100;
+
+    void publish() {
+        back_ = middle_.exchange(back_ | dirty_bit, std::memory_order::acq_rel) & index_mask;
+    }
+
+    struct alignas(cache_line_size) Buffer {
+        T value;
+    } buffers_[3];
+
+    alignas(cache_line_size) std::atomic<uint8_t> middle_ = 1;
+    alignas(cache_line_size) uint8_t back_                = 2;
+    alignas(cache_line_size) uint8_t front_               = 0;
+};
+
+// Every value in order, for a single producer and a single consumer, e.g. a byte stream from a
+// serial port. Writes are dropped when the queue is full.
+template <typename T, size_t capacity>
+requires(std::has_single_bit(capacity) && std::is_trivially_copyable_v<T>) class SpscQueue {
+public:
+    bool write(const T& value) { return write(&value, 1) == 1; }
+
+    // Returns how many values were written.
+    size_t write(const T* values, size_t count) {
+        auto tail = tail_.load(std::memory_order::relaxed);
+        if (capacity - (tail - cached_head_) < count)
+            cached_head_ = head_.load(std::memory_order::acquire);
+        count = std::min(count, capacity - (tail - cached_head_));
+
+        for (size_t i = 0; i < count; i++)
+            storage_[(tail + i) & (capacity - 1)] = values[i];
+        tail_.store(tail + count, std::memory_order::release);
+        return count;
+    }
+
+    std::optional<T> read() {
+        T value;
+        if (read(&value, 1) == 0)
+            return std::nullopt;
+        return value;
+    }
+
+    // Returns how many values were read.
+    size_t read(T* values, size_t count) {
+        auto head = head_.load(std::memory_order::relaxed);
+        if (cached_tail_ - head < count)
+            cached_tail_ = tail_.load(std::memory_order::acquire);
+        count = std::min(count, cached_tail_ - head);
+
+        for (size_t i = 0; i < count; i++)
+            values[i] = storage_[(head + i) & (capacity - 1)];
+        head_.store(head + count, std::memory_order::release);
+        return count;
+    }
+
+private:
+    // Both indices only grow: their difference is the number of values in the queue.
+    alignas(cache_line_size) std::atomic<size_t> tail_ = 0;
+    size_t cached_head_                                = 0;
+    alignas(cache_line_size) std::atomic<size_t> head_ = 0;
+    size_t cached_tail_                                = 0;
+
+    alignas(cache_line_size) T storage_[capacity];
+};
+
+// Samples of one quantity written since the previous read, or only the latest (and a count of 0)
+// when there was none.
+struct SampleSummary {
+    size_t count;
+    double latest, mean, min, max;
+};
+
+// Every sample of N quantities written since the previous read, summarized per quantity, for a
+// single producer faster than or out of phase with the reader (an IMU, motor feedback). The
+// producer does the accumulation: the reader only takes a SeqLock snapshot and acknowledges it.
+template <size_t N>
+class Aggregator {
+public:
+    using Sample = std::array<double, N>;
+
+    void write(const Sample& sample) {
+        history_[count_ % history_size] = sample;
+        count_++;
+        for (size_t i = 0; i < N; i++)
+            sum_[i] += sample[i];
+
+        // Restarts the extrema from the samples the reader has not seen once it acknowledges a
+        // read. History covers the samples written between the read and the acknowledgement.
+        auto acknowledged = acknowledged_.load(std::memory_order::acquire);
+        if (acknowledged != window_begin_ || count_ - 1 == window_begin_) {
+            window_begin_ = acknowledged;
+            min_ = max_ = sample;
+            for (auto k = std::max(acknowledged, count_ - std::min(count_, history_size));
+                 k < count_ - 1; k++) {
+                const auto& previous = history_[k % history_size];
+                for (size_t i = 0; i < N; i++) {
+                    min_[i] = std::min(min_[i], previous[i]);
+                    max_[i] = std::max(max_[i], previous[i]);
+                }
+            }
+        } else {
+            for (size_t i = 0; i < N; i++) {
+                min_[i] = std::min(min_[i], sample[i]);
+                max_[i] = std::max(max_[i], sample[i]);
+            }
+        }
+
+        State state{count_, window_begin_, sum_, sample, min_, max_, {}};
+        for (auto k = count_ - std::min(count_, recent_size); k < count_; k++)
+            state.recent[k % recent_size] = history_[k % history_size];
+        state_.write(state);
+    }
+
+    std::array<SampleSummary, N> read() { return summarize(state_.read()); }
+
+private:
+    static constexpr uint64_t history_size = 16;
+    static constexpr uint64_t recent_size  = 4;
+
+    // Sums are cumulative, so that the mean is exact however the two sides interleave. Extrema
+    // cover the samples since window_begin, the last acknowledgement the producer saw.
+    struct State {
+        uint64_t count, window_begin;
+        Sample sum, latest, min, max;
+        std::array<Sample, recent_size> recent; // Sample k at k % recent_size
+    };
+
+    std::array<SampleSummary, N> summarize(const State& state) {
+        auto count = state.count - read_count_;
+
+        // Samples written between a read and its acknowledgement extend the extrema of the window
+        // already read, which then covers samples of the previous read too. The samples of this
+        // read are taken from the recent ones instead, unless the producer has not seen the
+        // acknowledgement for that many samples, where the extrema are those of the wider window.
+        auto min = state.min, max = state.max;
+        if (count != 0 && state.window_begin != read_count_ && count <= recent_size) {
+            min = max = state.recent[read_count_ % recent_size];
+            for (auto k = read_count_ + 1; k < state.count; k++) {
+                const auto& sample = state.recent[k % recent_size];
+                for (size_t i = 0; i < N; i++) {
+                    min[i] = std::min(min[i], sample[i]);
+                    max[i] = std::max(max[i], sample[i]);
+                }
+            }
+        }
+
+        std::array<SampleSummary, N> summaries;
+        for (size_t i = 0; i < N; i++) {
+            auto latest = state.latest[i];
+            if (count)
+                summaries[i] = {
+                    count, latest, (state.sum[i] - read_sum_[i]) / static_cast<double>(count),
+                    min[i], max[i]};
+            else
+                summaries[i] = {0, latest, latest, latest, latest};
+        }
+
+        read_count_ = state.count;
+        read_sum_   = state.sum;
+        acknowledged_.store(read_count_, std::memory_order::release);
+        return summaries;
+    }
+
+    // Lets the tests interleave writes with the steps of a read.
+    friend class AggregatorTest;
+
+    SeqLock<State> state_{State{}};
+
+    // Producer side.
+    Sample history_[history_size];
+    uint64_t count_ = 0, window_begin_ = 0;
+    Sample sum_{}, min_{}, max_{};
+
+    // Reader side.
+    alignas(cache_line_size) std::atomic<uint64_t> acknowledged_ = 0;
+    uint64_t read_count_                                         = 0;
+    Sample read_sum_{};
+};
+
+} // namespace rmcs_executor::mailbox
\ No newline at end of file
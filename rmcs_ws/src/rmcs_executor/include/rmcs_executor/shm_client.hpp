@@ -0,0 +1,165 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include "rmcs_executor/byte_copyable.hpp"
+#include "rmcs_executor/shm_layout.hpp"
+
+namespace rmcs_executor::shm {
+
+// Reads the outputs exported by an executor (parameter `shm_export.name`) from another process.
+// Reading never blocks the executor: a read overlapping a write is simply retried.
+//
+//     rmcs_executor::shm::Client client{"/rmcs_executor"};
+//     auto yaw = client.find("/gimbal/yaw/angle");
+//     rmcs_executor::shm::Client::Snapshot snapshot;
+//     if (client.read(snapshot))
+//         double angle = snapshot.get<double>(*yaw);
+class Client {
+public:
+    class Snapshot {
+    public:
+        friend class Client;
+
+        uint64_t tick() const { return frame_header().tick; }
+        std::chrono::steady_clock::time_point timestamp() const {
+            return std::chrono::steady_clock::time_point{
+                std::chrono::nanoseconds{frame_header().timestamp}};
+        }
+
+        template <typename T>
+        T get(const Channel& channel) const {
+            check_type<T>(channel);
+            T value;
+            std::memcpy(
+                &value, reinterpret_cast<const std::byte*>(data_.data()) + channel.offset,
+                sizeof(T));
+            return value;
+        }
+
+    private:
+        FrameHeader frame_header() const {
+            FrameHeader header;
+            std::memcpy(&header, data_.data(), sizeof(header));
+            return header;
+        }
+
+        std::vector<uint64_t> data_;
+    };
+
+    explicit Client(const std::string& name) {
+        fd_ = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd_ < 0)
+            throw std::runtime_error{"Unable to open shared memory " + name};
+
+        struct stat segment_stat;
+        if (fstat(fd_, &segment_stat) != 0
+            || segment_stat.st_size < static_cast<off_t>(sizeof(Header))) {
+            ::close(fd_);
+            throw std::runtime_error{"Invalid shared memory " + name};
+        }
+        size_ = static_cast<size_t>(segment_stat.st_size);
+
+        auto pointer = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (pointer == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error{"Unable to map shared memory " + name};
+        }
+        base_ = static_cast<std::byte*>(pointer);
+
+        if (std::memcmp(header().magic, magic, sizeof(magic)) != 0
+            || header().version != version) {
+            munmap(base_, size_);
+            ::close(fd_);
+            throw std::runtime_error{"Unsupported shared memory " + name};
+        }
+    }
+
+    Client(const Client&)            = delete;
+    Client& operator=(const Client&) = delete;
+    Client(Client&&)                 = delete;
+    Client& operator=(Client&&)      = delete;
+
+    ~Client() {
+        munmap(base_, size_);
+        ::close(fd_);
+    }
+
+    bool closed() const { return header().closed.load(std::memory_order::relaxed) != 0; }
+
+    size_t channel_count() const { return header().channel_count; }
+    const Channel& channel(size_t index) const {
+        return reinterpret_cast<const Channel*>(base_ + sizeof(Header))[index];
+    }
+
+    // Returns nullptr if the output is not exported.
+    const Channel* find(const std::string& name) const {
+        for (size_t i = 0; i < channel_count(); i++) {
+            if (name == channel(i).name)
+                return &channel(i);
+        }
+        return nullptr;
+    }
+
+    // Copies a coherent snapshot of every channel. Returns false if every attempt overlapped a
+    // write, which only happens if the reader is preempted for a whole tick repeatedly.
+    bool read(Snapshot& snapshot, size_t max_attempts = 1000) const {
+        snapshot.data_.resize(header().data_size / 8);
+        return read_consistently(
+            [&]() { load_words(snapshot.data_.data(), data(), header().data_size); },
+            max_attempts);
+    }
+
+    // Reads a single channel, cheaper than a full snapshot.
+    template <typename T>
+    bool read(const Channel& channel, T& value, size_t max_attempts = 1000) const {
+        check_type<T>(channel);
+        return read_consistently(
+            [&]() { load_words(&value, data() + channel.offset / 8, sizeof(T)); }, max_attempts);
+    }
+
+private:
+    template <typename T>
+    static void check_type(const Channel& channel) {
+        static_assert(is_byte_copyable_v<T>);
+        if (channel.size != sizeof(T) || std::strcmp(channel.type, typeid(T).name()) != 0)
+            throw std::runtime_error{std::string{"Type not match with channel "} + channel.name};
+    }
+
+    template <typename F>
+    bool read_consistently(F&& copy, size_t max_attempts) const {
+        auto& sequence = header().sequence;
+        for (size_t i = 0; i < max_attempts; i++) {
+            auto begin = sequence.load(std::memory_order::acquire);
+            if (begin & 1)
+                continue;
+            copy();
+            std::atomic_thread_fence(std::memory_order::acquire);
+            if (sequence.load(std::memory_order::relaxed) == begin)
+                return true;
+        }
+        return false;
+    }
+
+    Header& header() const { return *reinterpret_cast<Header*>(base_); }
+    uint64_t* data() const { return reinterpret_cast<uint64_t*>(base_ + header().data_offset); }
+
+    int fd_;
+    size_t size_;
+    std::byte* base_;
+};
+
+} // namespace rmcs_executor::shm
\ No newline at end of file
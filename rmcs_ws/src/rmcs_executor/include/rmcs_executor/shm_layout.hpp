@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace rmcs_executor::shm {
+
+// Layout of the shared-memory segment exported by the executor:
+//   Header, then `channel_count` Channel entries, then the data block at `data_offset`.
+// The data block starts with a FrameHeader followed by the value of every channel. It is rewritten
+// once per tick under a seqlock: `sequence` is odd while the executor is writing.
+
+constexpr char magic[8]    = {'R', 'M', 'C', 'S', 'S', 'H', 'M', '1'};
+constexpr uint32_t version = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t channel_count;
+    uint64_t data_offset;
+    uint64_t data_size;
+
+    // Set when the executor exits. Clients should reopen the segment to follow a new executor.
+    alignas(64) std::atomic<uint32_t> closed;
+    alignas(64) std::atomic<uint64_t> sequence;
+};
+
+struct Channel {
+    char name[112];
+    char type[128]; // Mangled name of the type
+    uint64_t offset; // Offset within the data block
+    uint64_t size;
+};
+
+struct FrameHeader {
+    uint64_t tick;
+    int64_t timestamp; // Nanoseconds since the epoch of std::chrono::steady_clock
+};
+
+// Values are copied word by word with relaxed atomic accesses, so that reading while the executor
+// writes is a detectable retry rather than undefined behavior. Sizes are padded to whole words.
+constexpr size_t padded_size(size_t size) { return (size + 7) / 8 * 8; }
+
+inline void store_words(uint64_t* destination, const void* source, size_t size) {
+    auto bytes = static_cast<const std::byte*>(source);
+    for (size_t i = 0; i < padded_size(size) / 8; i++) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + i * 8, i * 8 + 8 <= size ? 8 : size - i * 8);
+        std::atomic_ref<uint64_t>{destination[i]}.store(word, std::memory_order::relaxed);
+    }
+}
+
+inline void load_words(void* destination, uint64_t* source, size_t size) {
+    auto bytes = static_cast<std::byte*>(destination);
+    for (size_t i = 0; i < padded_size(size) / 8; i++) {
+        auto word = std::atomic_ref<uint64_t>{source[i]}.load(std::memory_order::relaxed);
+        std::memcpy(bytes + i * 8, &word, i * 8 + 8 <= size ? 8 : size - i * 8);
+    }
+}
+
+} // namespace rmcs_executor::shm
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rmcs_executor/mailbox.hpp"
+
+namespace rmcs_executor::trace {
+
+// Timeline of the control loop and the threads around it, written by the executor as Chrome trace
+// events (see parameters `trace.*`). Recording is off unless the executor turns it on, and then
+// only costs a relaxed load when it is off.
+//
+//     void can1_receive_callback(...) override {
+//         rmcs_executor::trace::Scope scope{"can1_receive", "usb"};
+//         ...
+//     }
+
+// Names and categories must outlive the trace (string literals, component names).
+struct Event {
+    const char* name;
+    const char* category;
+    int64_t begin; // Nanoseconds since the epoch of std::chrono::steady_clock
+    int64_t duration;
+};
+
+// Written by its own thread only, drained by the trace writer.
+struct ThreadBuffer {
+    static constexpr size_t capacity = 16384;
+
+    std::string thread_name;
+    uint64_t thread_id;
+    mailbox::SpscQueue<Event, capacity> events;
+    std::atomic<size_t> dropped_count = 0;
+};
+
+// Shared with components loaded as plugins through the library, see src/trace.cpp.
+namespace detail {
+extern std::atomic<bool> enabled;
+ThreadBuffer& this_thread_buffer();
+} // namespace detail
+
+inline bool enabled() { return detail::enabled.load(std::memory_order::relaxed); }
+inline void set_enabled(bool enabled) {
+    detail::enabled.store(enabled, std::memory_order::relaxed);
+}
+
+// Name shown for the calling thread, to be set before its first event.
+void set_thread_name(std::string name);
+
+// Once called, set_thread_name() also allocates the buffer of the thread it names, so that the
+// first event of real-time threads (control, workers, partitions) does not allocate mid-tick.
+// Called by the executor when a trace path is set, before starting those threads.
+void reserve_named_thread_buffers();
+
+inline int64_t now() { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+
+// For callers already timing the span themselves.
+inline void record(const char* name, const char* category, int64_t begin, int64_t end) {
+    auto& buffer = detail::this_thread_buffer();
+    if (!buffer.events.write(Event{name, category, begin, end - begin}))
+        buffer.dropped_count.fetch_add(1, std::memory_order::relaxed);
+}
+
+// Records the span between its construction and destruction, if tracing was on at construction.
+class Scope {
+public:
+    Scope(const char* name, const char* category)
+        : name_(name)
+        , category_(category)
+        , begin_(enabled() ? now() : -1) {}
+
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope(Scope&&)                 = delete;
+    Scope& operator=(Scope&&)      = delete;
+
+    ~Scope() {
+        if (begin_ >= 0) [[unlikely]]
+            record(name_, category_, begin_, now());
+    }
+
+private:
+    const char* name_;
+    const char* category_;
+    int64_t begin_;
+};
+
+// Buffers of every thread that has recorded an event so far.
+std::vector<std::shared_ptr<ThreadBuffer>> thread_buffers();
+
+} // namespace rmcs_executor::trace
\ No newline at end of file
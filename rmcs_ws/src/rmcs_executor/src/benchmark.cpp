@@ -0,0 +1,310 @@
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <rclcpp/executors.hpp>
+
+#include "executor.hpp"
+#include "rmcs_executor/component.hpp"
+
+// Measures the cost of the executor itself on synthetic component graphs:
+//   rmcs_executor_benchmark [--sizes 10,100,1000,10000] [--fan-in 2] [--fan-out 1]
+//                           [--ticks 10000] [--workers 0] [--seed 1] [--output result.json]
+//                           [--pipelines plugin,fused,untimed]
+// Every component reads `fan-in` outputs picked at random from the components created before it,
+// and writes `fan-out` outputs of its own. Each graph is updated through virtual calls (plugin),
+// and through a fused pipeline calling the components directly, with and without timing. Results
+// are printed as JSON.
+
+namespace {
+
+class SyntheticComponent final : public rmcs_executor::Component {
+public:
+    SyntheticComponent(const std::vector<std::string>& input_names, size_t index, size_t fan_out)
+        : input_count_(input_names.size())
+        , output_count_(fan_out)
+        , inputs_(std::make_unique<InputInterface<double>[]>(input_count_))
+        , outputs_(std::make_unique<OutputInterface<double>[]>(output_count_)) {
+        for (size_t i = 0; i < input_count_; i++)
+            register_input(input_names[i], inputs_[i]);
+        for (size_t i = 0; i < output_count_; i++)
+            register_output(output_name(index, i), outputs_[i], 0.0);
+        mark_as_sink();
+    }
+
+    static std::string output_name(size_t index, size_t output) {
+        return "/benchmark/" + std::to_string(index) + "/" + std::to_string(output);
+    }
+
+    void update() override {
+        double sum = 1.0;
+        for (size_t i = 0; i < input_count_; i++)
+            sum += *inputs_[i];
+        for (size_t i = 0; i < output_count_; i++)
+            *outputs_[i] = sum * 0.5;
+    }
+
+private:
+    size_t input_count_, output_count_;
+    std::unique_ptr<InputInterface<double>[]> inputs_;
+    std::unique_ptr<OutputInterface<double>[]> outputs_;
+};
+
+// Which components the fused pipeline calls directly, by position in the updating order, as
+// generate_fused_pipeline.py would bake them in. Others are updated through virtual calls.
+std::vector<bool> fused_entries;
+
+template <bool timed>
+void update_fused(rmcs_executor::UpdateEntry* entries, size_t tick) {
+    for (size_t i = 0; i < fused_entries.size(); i++) {
+        if (fused_entries[i]) {
+            entries[i].update<timed>(tick, [component = entries[i].component]() {
+                static_cast<SyntheticComponent*>(component)->SyntheticComponent::update();
+            });
+        } else {
+            entries[i].update<timed>(tick);
+        }
+    }
+}
+
+struct Options {
+    std::vector<size_t> sizes = {10, 100, 1000, 10000};
+    std::vector<std::string> pipelines = {"plugin", "fused", "untimed"};
+    size_t fan_in = 2, fan_out = 1, ticks = 10000, workers = 0, seed = 1;
+    std::string output;
+};
+
+struct Result {
+    std::string pipeline;
+    size_t component_count, edge_count;
+    double construct_ms, initialize_ms;
+    double tick_mean_us, tick_p99_us, tick_max_us;
+    double bytes_per_component;
+};
+
+// Large blocks like the latency histograms are served by mmap and not counted in uordblks.
+size_t allocated_bytes() {
+    auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+std::shared_ptr<rmcs_executor::Executor> make_executor(
+    rmcs_executor::SpinExecutor& rcl_executor, const std::vector<std::vector<std::string>>& names,
+    size_t fan_out) {
+    auto executor = std::make_shared<rmcs_executor::Executor>("rmcs_executor", rcl_executor);
+    for (size_t i = 0; i < names.size(); i++) {
+        auto component_name = "synthetic_" + std::to_string(i);
+        rmcs_executor::Component::initializing_component_name = component_name.c_str();
+        executor->add_component(std::make_shared<SyntheticComponent>(names[i], i, fan_out));
+    }
+    return executor;
+}
+
+// A fused pipeline is baked for the order the executor resolves, taken from a scratch executor
+// initialized with the same graph.
+rmcs_executor::FusedPipeline make_fused_pipeline(
+    const std::vector<std::vector<std::string>>& names, size_t fan_out, bool timed) {
+    rmcs_executor::SpinExecutor rcl_executor;
+    auto scratch = make_executor(rcl_executor, names, fan_out);
+    scratch->initialize();
+
+    rmcs_executor::FusedPipeline pipeline{};
+    fused_entries.clear();
+    for (auto component : scratch->updating_order()) {
+        bool fused = typeid(*component) == typeid(SyntheticComponent);
+        pipeline.updating_order.emplace_back(component->get_component_name());
+        pipeline.types.emplace_back(fused ? &typeid(SyntheticComponent) : nullptr);
+        fused_entries.emplace_back(fused);
+    }
+    pipeline.update = timed ? update_fused<true> : update_fused<false>;
+    pipeline.timed  = timed;
+    return pipeline;
+}
+
+Result run(const Options& options, size_t component_count, const std::string& pipeline) {
+    using clock = std::chrono::steady_clock;
+    auto to_ms  = [](clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    Result result{};
+    result.pipeline        = pipeline;
+    result.component_count = component_count;
+
+    auto random = std::mt19937_64{options.seed};
+    auto names  = std::vector<std::vector<std::string>>(component_count);
+    for (size_t i = 1; i < component_count; i++) {
+        auto pick = std::uniform_int_distribution<size_t>{0, i - 1};
+        for (size_t j = 0; j < options.fan_in; j++) {
+            auto name = SyntheticComponent::output_name(pick(random), j % options.fan_out);
+            if (std::find(names[i].begin(), names[i].end(), name) == names[i].end())
+                names[i].emplace_back(std::move(name));
+        }
+        result.edge_count += names[i].size();
+    }
+
+    std::optional<rmcs_executor::FusedPipeline> fused_pipeline;
+    if (pipeline != "plugin")
+        fused_pipeline = make_fused_pipeline(names, options.fan_out, pipeline == "fused");
+
+    auto allocated_before = allocated_bytes();
+    auto begin            = clock::now();
+
+    rmcs_executor::SpinExecutor rcl_executor;
+    auto executor = make_executor(rcl_executor, names, options.fan_out);
+    if (fused_pipeline)
+        executor->set_fused_pipeline(std::move(*fused_pipeline));
+    auto constructed = clock::now();
+    executor->initialize();
+    auto initialized = clock::now();
+
+    result.construct_ms        = to_ms(constructed - begin);
+    result.initialize_ms       = to_ms(initialized - constructed);
+    result.bytes_per_component = static_cast<double>(allocated_bytes() - allocated_before)
+                               / static_cast<double>(component_count);
+
+    auto tick_durations = std::vector<double>(options.ticks);
+    for (size_t i = 0; i < options.ticks; i++) {
+        auto tick_begin = clock::now();
+        executor->update_once();
+        tick_durations[i] =
+            std::chrono::duration<double, std::micro>(clock::now() - tick_begin).count();
+    }
+    if (!tick_durations.empty()) {
+        double sum = 0;
+        for (auto duration : tick_durations)
+            sum += duration;
+        result.tick_mean_us = sum / static_cast<double>(tick_durations.size());
+
+        std::sort(tick_durations.begin(), tick_durations.end());
+        result.tick_p99_us = tick_durations[(tick_durations.size() - 1) * 99 / 100];
+        result.tick_max_us = tick_durations.back();
+    }
+
+    return result;
+}
+
+std::vector<std::string> split(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream{text};
+    for (std::string item; std::getline(stream, item, ',');)
+        items.emplace_back(std::move(item));
+    return items;
+}
+
+std::vector<size_t> parse_sizes(const std::string& text) {
+    std::vector<size_t> sizes;
+    for (const auto& item : split(text))
+        sizes.emplace_back(std::stoul(item));
+    return sizes;
+}
+
+std::vector<std::string> parse_pipelines(const std::string& text) {
+    auto pipelines = split(text);
+    for (const auto& pipeline : pipelines) {
+        if (pipeline != "plugin" && pipeline != "fused" && pipeline != "untimed")
+            throw std::runtime_error{"Unknown pipeline " + pipeline};
+    }
+    return pipelines;
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string key = argv[i];
+        if (i + 1 == argc)
+            throw std::runtime_error{"Missing value of option " + key};
+        std::string value = argv[++i];
+
+        if (key == "--sizes")
+            options.sizes = parse_sizes(value);
+        else if (key == "--fan-in")
+            options.fan_in = std::stoul(value);
+        else if (key == "--fan-out")
+            options.fan_out = std::max<size_t>(std::stoul(value), 1);
+        else if (key == "--ticks")
+            options.ticks = std::stoul(value);
+        else if (key == "--workers")
+            options.workers = std::stoul(value);
+        else if (key == "--seed")
+            options.seed = std::stoul(value);
+        else if (key == "--output")
+            options.output = value;
+        else if (key == "--pipelines")
+            options.pipelines = parse_pipelines(value);
+        else
+            throw std::runtime_error{"Unknown option " + key};
+    }
+    return options;
+}
+
+std::string to_json(const Options& options, const std::vector<Result>& results) {
+    std::stringstream json;
+    json << "{\n";
+    json << "  \"fan_in\": " << options.fan_in << ",\n";
+    json << "  \"fan_out\": " << options.fan_out << ",\n";
+    json << "  \"ticks\": " << options.ticks << ",\n";
+    json << "  \"workers\": " << options.workers << ",\n";
+    json << "  \"seed\": " << options.seed << ",\n";
+    json << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        json << "    {\"pipeline\": \"" << result.pipeline << "\""
+             << ", \"components\": " << result.component_count
+             << ", \"edges\": " << result.edge_count
+             << ", \"construct_ms\": " << result.construct_ms
+             << ", \"initialize_ms\": " << result.initialize_ms
+             << ", \"tick_mean_us\": " << result.tick_mean_us
+             << ", \"tick_p99_us\": " << result.tick_p99_us
+             << ", \"tick_max_us\": " << result.tick_max_us
+             << ", \"bytes_per_component\": " << result.bytes_per_component << "}"
+             << (i + 1 == results.size() ? "\n" : ",\n");
+    }
+    json << "  ]\n}\n";
+    return json.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto options = parse_options(argc, argv);
+
+    // Only the executor itself is measured: no diagnostics, no logging below warnings.
+    auto ros_arguments = std::vector<std::string>{
+        argv[0], "--ros-args", "-p", "update_rate:=1000.0", "-p", "diagnostics_period:=0.0", "-p",
+        "parallel_workers:=" + std::to_string(options.workers), "--log-level", "warn"};
+    auto ros_argv = std::vector<const char*>{};
+    for (const auto& argument : ros_arguments)
+        ros_argv.emplace_back(argument.c_str());
+    rclcpp::init(static_cast<int>(ros_argv.size()), ros_argv.data());
+
+    std::vector<Result> results;
+    for (auto size : options.sizes) {
+        for (const auto& pipeline : options.pipelines) {
+            results.emplace_back(run(options, size, pipeline));
+            std::cerr << "pipeline=" << pipeline << " components=" << size
+                      << " initialize_ms=" << results.back().initialize_ms
+                      << " tick_mean_us=" << results.back().tick_mean_us << '\n';
+        }
+    }
+
+    auto json = to_json(options, results);
+    if (options.output.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream file{options.output};
+        file << json;
+    }
+
+    rclcpp::shutdown();
+}
\ No newline at end of file
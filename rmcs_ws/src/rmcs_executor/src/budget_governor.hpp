@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "update_entry.hpp"
+
+namespace rmcs_executor {
+
+// Keeps critical components on time when ticks overrun: once overruns are sustained, best-effort
+// components are first updated at a lower rate, then skipped, and restored one step at a time
+// once the ticks have had headroom for a while.
+class BudgetGovernor {
+public:
+    enum class Level : uint8_t { NORMAL = 0, REDUCED_RATE = 1, SKIPPED = 2 };
+
+    struct Config {
+        // A tick overruns when it misses its deadline, or when a component exceeds its budget.
+        // Components are degraded once `overrun_ticks` of the last `window_ticks` overrun, and
+        // restored after `recovery_ticks` ticks in a row without any.
+        size_t window_ticks   = 100;
+        size_t overrun_ticks  = 10;
+        size_t recovery_ticks = 1000;
+
+        // Applied on top of their own divisor to best-effort components at the reduced rate.
+        size_t divisor = 10;
+    };
+
+    struct BudgetedEntry {
+        std::string name;
+        UpdateEntry* entry;
+        std::atomic<size_t> overrun_count = 0;
+        size_t reported_overrun_count     = 0;
+    };
+
+    explicit BudgetGovernor(const Config& config)
+        : config_(config)
+        , window_(config.window_ticks, false) {}
+
+    void add_budgeted(std::string name, UpdateEntry& entry) {
+        budgeted_entries_.emplace_back(std::move(name), &entry);
+    }
+
+    void add_best_effort(UpdateEntry& entry) {
+        best_effort_entries_.emplace_back(&entry, entry.divisor);
+    }
+
+    // Called by the control thread after each tick.
+    void check(bool missed_deadline) {
+        bool overrun = missed_deadline;
+        for (auto& budgeted : budgeted_entries_) {
+            if (!budgeted.entry->overran)
+                continue;
+            budgeted.entry->overran = false;
+            budgeted.overrun_count.store(
+                budgeted.overrun_count.load(std::memory_order::relaxed) + 1,
+                std::memory_order::relaxed);
+            overrun = true;
+        }
+
+        window_overrun_count_ += overrun;
+        window_overrun_count_ -= window_[window_index_];
+        window_[window_index_] = overrun;
+        window_index_          = (window_index_ + 1) % window_.size();
+
+        auto level = this->level();
+        if (overrun) {
+            clean_ticks_ = 0;
+            if (window_overrun_count_ >= config_.overrun_ticks && level != Level::SKIPPED) {
+                set_level(static_cast<Level>(static_cast<uint8_t>(level) + 1));
+                degrade_count_.fetch_add(1, std::memory_order::relaxed);
+                // Judge the new level on its own.
+                std::fill(window_.begin(), window_.end(), false);
+                window_overrun_count_ = 0;
+            }
+        } else if (++clean_ticks_ >= config_.recovery_ticks && level != Level::NORMAL) {
+            set_level(static_cast<Level>(static_cast<uint8_t>(level) - 1));
+            clean_ticks_ = 0;
+        }
+    }
+
+    Level level() const { return level_.load(std::memory_order::relaxed); }
+    size_t degrade_count() const { return degrade_count_.load(std::memory_order::relaxed); }
+    std::deque<BudgetedEntry>& budgeted_entries() { return budgeted_entries_; }
+
+private:
+    void set_level(Level level) {
+        for (auto& [entry, nominal_divisor] : best_effort_entries_) {
+            entry->skipped = level == Level::SKIPPED;
+            entry->divisor =
+                level == Level::NORMAL ? nominal_divisor : nominal_divisor * config_.divisor;
+        }
+        level_.store(level, std::memory_order::relaxed);
+    }
+
+    struct BestEffortEntry {
+        UpdateEntry* entry;
+        size_t nominal_divisor;
+    };
+
+    Config config_;
+    std::deque<BudgetedEntry> budgeted_entries_;
+    std::vector<BestEffortEntry> best_effort_entries_;
+
+    std::vector<bool> window_;
+    size_t window_index_ = 0, window_overrun_count_ = 0;
+    size_t clean_ticks_  = 0;
+
+    std::atomic<Level> level_           = Level::NORMAL;
+    std::atomic<size_t> degrade_count_ = 0;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
@@ -3,5 +3,6 @@
 namespace rmcs_executor {
 
 const char* Component::initializing_component_name;
+rclcpp::ParameterMap Component::parameter_map_;
 
 } // namespace rmcs_executor
\ No newline at end of file
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rmcs_executor::data_log {
+
+// Layout of a data log file:
+//   Header, then for every channel a ChannelHeader followed by its name and its type name, then
+//   fixed-size frames: FrameHeader followed by the raw bytes of every channel in order.
+// Only byte-copyable values are logged, tagged with the mangled name of their type.
+//
+// The file is allocated ahead of the frames, so its size says nothing about how many were written.
+// The writer commits the count to the header after every batch, which keeps a log left behind by a
+// crash readable up to its last batch.
+
+constexpr char magic[8]    = {'R', 'M', 'C', 'S', 'L', 'O', 'G', '1'};
+constexpr uint32_t version = 2;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t channel_count;
+    uint64_t frame_size;
+    uint64_t frame_count;
+};
+
+struct ChannelHeader {
+    uint32_t size;
+    uint16_t name_length;
+    uint16_t type_length;
+};
+
+struct FrameHeader {
+    uint64_t tick;
+    int64_t timestamp; // Nanoseconds since the epoch of std::chrono::steady_clock
+};
+
+struct Channel {
+    std::string name;
+    std::string type;
+    size_t size;
+    size_t offset; // Offset within a frame
+};
+
+// Frames are copied into a single-producer single-consumer ring by the control thread, and written
+// to a memory-mapped file by a background thread, so that disk I/O never blocks the control loop.
+// Chunks of the file are allocated before being mapped, so that a full disk fails the allocation
+// instead of faulting on a store: recording then stops, and every later frame counts as dropped.
+class Writer {
+public:
+    struct Source {
+        std::string name;
+        std::string type;
+        size_t size;
+        const void* data;
+    };
+
+    Writer(const std::string& path, std::vector<Source> sources, size_t ring_capacity = 4096)
+        : sources_(std::move(sources))
+        , ring_capacity_(ring_capacity) {
+
+        std::vector<std::byte> header_bytes;
+        auto append = [&header_bytes](const void* data, size_t size) {
+            auto begin = static_cast<const std::byte*>(data);
+            header_bytes.insert(header_bytes.end(), begin, begin + size);
+        };
+
+        frame_size_ = sizeof(FrameHeader);
+        for (const auto& source : sources_)
+            frame_size_ += source.size;
+
+        Header header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version       = version;
+        header.channel_count = static_cast<uint32_t>(sources_.size());
+        header.frame_size    = frame_size_;
+        append(&header, sizeof(header));
+        for (const auto& source : sources_) {
+            ChannelHeader channel_header{
+                static_cast<uint32_t>(source.size), static_cast<uint16_t>(source.name.size()),
+                static_cast<uint16_t>(source.type.size())};
+            append(&channel_header, sizeof(channel_header));
+            append(source.name.data(), source.name.size());
+            append(source.type.data(), source.type.size());
+        }
+
+        ring_ = std::make_unique<std::byte[]>(frame_size_ * ring_capacity_);
+
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0)
+            throw std::runtime_error{"Unable to open data log " + path};
+        if (!write_to_file(header_bytes.data(), header_bytes.size())) {
+            ::close(fd_);
+            throw std::runtime_error{"Unable to write data log " + path + ": " + error_};
+        }
+
+        thread_ = std::thread{[this]() { writer_main(); }};
+    }
+
+    Writer(const Writer&)            = delete;
+    Writer& operator=(const Writer&) = delete;
+    Writer(Writer&&)                 = delete;
+    Writer& operator=(Writer&&)      = delete;
+
+    ~Writer() {
+        stopping_.store(true, std::memory_order::release);
+        thread_.join();
+
+        unmap_chunk();
+        if (ftruncate(fd_, static_cast<off_t>(file_size_)) != 0) {
+            // Nothing sensible left to do, the log is still readable up to its last full frame.
+        }
+        ::close(fd_);
+    }
+
+    // Called by the control thread. Returns false if the frame is dropped because the ring is
+    // full.
+    bool record(uint64_t tick, std::chrono::steady_clock::time_point timestamp) {
+        auto head = head_.load(std::memory_order::relaxed);
+        if (failed_.load(std::memory_order::relaxed)
+            || head - tail_.load(std::memory_order::acquire) == ring_capacity_) {
+            dropped_count_.fetch_add(1, std::memory_order::relaxed);
+            return false;
+        }
+
+        auto frame = ring_.get() + (head % ring_capacity_) * frame_size_;
+        FrameHeader frame_header{tick, timestamp.time_since_epoch().count()};
+        std::memcpy(frame, &frame_header, sizeof(frame_header));
+        frame += sizeof(frame_header);
+        for (const auto& source : sources_) {
+            std::memcpy(frame, source.data, source.size);
+            frame += source.size;
+        }
+
+        head_.store(head + 1, std::memory_order::release);
+        return true;
+    }
+
+    size_t dropped_count() const { return dropped_count_.load(std::memory_order::relaxed); }
+
+    // Why recording stopped, or nullptr while it goes on.
+    const char* error() const {
+        return failed_.load(std::memory_order::acquire) ? error_.c_str() : nullptr;
+    }
+
+private:
+    void writer_main() {
+        while (true) {
+            bool stopping = stopping_.load(std::memory_order::acquire);
+
+            auto tail           = tail_.load(std::memory_order::relaxed);
+            auto head           = head_.load(std::memory_order::acquire);
+            auto previous_count = written_count_;
+            for (; tail != head; tail++) {
+                if (!failed_.load(std::memory_order::relaxed)) {
+                    if (write_to_file(
+                            ring_.get() + (tail % ring_capacity_) * frame_size_, frame_size_))
+                        written_count_++;
+                    else
+                        failed_.store(true, std::memory_order::release);
+                }
+                // Frames recorded before the control thread noticed the failure.
+                if (failed_.load(std::memory_order::relaxed))
+                    dropped_count_.fetch_add(1, std::memory_order::relaxed);
+                tail_.store(tail + 1, std::memory_order::release);
+            }
+            if (written_count_ != previous_count)
+                commit_frame_count();
+
+            if (stopping)
+                return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    // Frames are written through the mapping, and the count through the file, both ending up in the
+    // same page cache: once the count is there, so are the frames it covers.
+    void commit_frame_count() {
+        uint64_t frame_count = written_count_;
+        if (pwrite(fd_, &frame_count, sizeof(frame_count), offsetof(Header, frame_count))
+            != sizeof(frame_count)) {
+            // The previous count stays, covering fewer frames than written.
+        }
+    }
+
+    // Returns false, with error_ set, if the file cannot grow.
+    bool write_to_file(const std::byte* data, size_t size) {
+        while (size) {
+            if (file_size_ == chunk_offset_ + chunk_size) {
+                unmap_chunk();
+                if (!map_chunk(file_size_))
+                    return false;
+            }
+            auto written = std::min(size, chunk_offset_ + chunk_size - file_size_);
+            std::memcpy(chunk_ + (file_size_ - chunk_offset_), data, written);
+            file_size_ += written;
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    bool map_chunk(size_t offset) {
+        if (int result = posix_fallocate(
+                fd_, static_cast<off_t>(offset), static_cast<off_t>(chunk_size));
+            result != 0) {
+            error_ = std::string{"Unable to grow data log: "} + std::strerror(result);
+            return false;
+        }
+        auto pointer = mmap(
+            nullptr, chunk_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+            static_cast<off_t>(offset));
+        if (pointer == MAP_FAILED) {
+            error_ = std::string{"Unable to map data log: "} + std::strerror(errno);
+            return false;
+        }
+        chunk_        = static_cast<std::byte*>(pointer);
+        chunk_offset_ = offset;
+        return true;
+    }
+
+    void unmap_chunk() {
+        if (chunk_)
+            munmap(chunk_, chunk_size);
+        chunk_ = nullptr;
+    }
+
+    static constexpr size_t chunk_size = 16 * 1024 * 1024;
+
+    std::vector<Source> sources_;
+    size_t frame_size_;
+
+    size_t ring_capacity_;
+    std::unique_ptr<std::byte[]> ring_;
+    alignas(64) std::atomic<size_t> head_ = 0;
+    alignas(64) std::atomic<size_t> tail_ = 0;
+    std::atomic<size_t> dropped_count_    = 0;
+
+    int fd_;
+    std::byte* chunk_ = nullptr;
+    // Starts "full" so that the first write maps the first chunk.
+    size_t chunk_offset_    = -chunk_size, file_size_ = 0;
+    uint64_t written_count_ = 0;
+
+    // Written by the writer thread before failed_ is set.
+    std::string error_;
+    std::atomic<bool> failed_ = false;
+
+    std::atomic<bool> stopping_ = false;
+    std::thread thread_;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            throw std::runtime_error{"Unable to open data log " + path};
+
+        struct stat file_stat;
+        if (fstat(fd_, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(Header)))
+            throw std::runtime_error{"Invalid data log " + path};
+        size_ = static_cast<size_t>(file_stat.st_size);
+
+        auto pointer = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (pointer == MAP_FAILED)
+            throw std::runtime_error{"Unable to map data log " + path};
+        data_ = static_cast<const std::byte*>(pointer);
+
+        Header header;
+        std::memcpy(&header, data_, sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version)
+            throw std::runtime_error{"Unsupported data log " + path};
+        frame_size_ = header.frame_size;
+
+        size_t position = sizeof(header);
+        size_t offset   = sizeof(FrameHeader);
+        for (uint32_t i = 0; i < header.channel_count; i++) {
+            ChannelHeader channel_header;
+            read_checked(position, &channel_header, sizeof(channel_header));
+
+            Channel channel;
+            channel.name.resize(channel_header.name_length);
+            read_checked(position, channel.name.data(), channel.name.size());
+            channel.type.resize(channel_header.type_length);
+            read_checked(position, channel.type.data(), channel.type.size());
+            channel.size   = channel_header.size;
+            channel.offset = offset;
+            offset += channel.size;
+
+            channels_.emplace_back(std::move(channel));
+        }
+        if (offset != frame_size_)
+            throw std::runtime_error{"Corrupted data log " + path};
+
+        // Never trust the count beyond the end of the file, e.g. if it was cut short.
+        frames_      = data_ + position;
+        frame_count_ = std::min<size_t>(header.frame_count, (size_ - position) / frame_size_);
+    }
+
+    Reader(const Reader&)            = delete;
+    Reader& operator=(const Reader&) = delete;
+    Reader(Reader&&)                 = delete;
+    Reader& operator=(Reader&&)      = delete;
+
+    ~Reader() {
+        munmap(const_cast<std::byte*>(data_), size_);
+        ::close(fd_);
+    }
+
+    const std::vector<Channel>& channels() const { return channels_; }
+    size_t frame_count() const { return frame_count_; }
+
+    FrameHeader frame_header(size_t index) const {
+        FrameHeader header;
+        std::memcpy(&header, frames_ + index * frame_size_, sizeof(header));
+        return header;
+    }
+    const std::byte* channel_data(size_t index, const Channel& channel) const {
+        return frames_ + index * frame_size_ + channel.offset;
+    }
+
+private:
+    void read_checked(size_t& position, void* destination, size_t size) const {
+        if (position + size > size_)
+            throw std::runtime_error{"Truncated data log header"};
+        std::memcpy(destination, data_ + position, size);
+        position += size;
+    }
+
+    int fd_;
+    size_t size_;
+    const std::byte* data_;
+
+    std::vector<Channel> channels_;
+    size_t frame_size_;
+    const std::byte* frames_;
+    size_t frame_count_;
+};
+
+} // namespace rmcs_executor::data_log
\ No newline at end of file
@@ -1,28 +1,60 @@
 #pragma once
 
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
 #include <map>
+#include <new>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rcl/arguments.h>
 #include <rclcpp/executors.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <rclcpp/node.hpp>
+#include <rclcpp/parameter_event_handler.hpp>
+#include <rclcpp/parameter_map.hpp>
+#include <rcpputils/scope_exit.hpp>
 
+#include "budget_governor.hpp"
+#include "data_log.hpp"
+#include "fused_pipeline.hpp"
+#include "latency_histogram.hpp"
+#include "parallel_scheduler.hpp"
+#include "partition.hpp"
+#include "partition_channel.hpp"
 #include "predefined_msg_provider.hpp"
+#include "realtime.hpp"
+#include "replay_provider.hpp"
+#include "shm_exporter.hpp"
+#include "spin_executor.hpp"
 #include "rmcs_executor/component.hpp"
+#include "rmcs_executor/trace.hpp"
+#include "staleness_monitor.hpp"
+#include "startup_profile.hpp"
+#include "trace_writer.hpp"
+#include "update_entry.hpp"
 
 namespace rmcs_executor {
 
 class Executor final : public rclcpp::Node {
 public:
-    explicit Executor(
-        const std::string& node_name, rclcpp::executors::SingleThreadedExecutor& rcl_executor)
+    explicit Executor(const std::string& node_name, SpinExecutor& rcl_executor)
         : Node{node_name, rclcpp::NodeOptions().automatically_declare_parameters_from_overrides(true)}
         , rcl_executor_(rcl_executor) {
+        load_component_parameters();
+
         Component::initializing_component_name = "predefined_msg_provider";
         predefined_msg_provider_               = std::make_shared<PredefinedMsgProvider>();
         add_component(predefined_msg_provider_);
@@ -30,6 +62,7 @@ public:
     ~Executor() {
         if (thread_.joinable())
             thread_.join();
+        partitions_.clear();
     };
 
     void add_component(std::shared_ptr<Component> component) {
@@ -40,41 +73,207 @@ public:
             add_component(partner_component);
     }
 
+    // Must be set before initialization. Ignored when updating in parallel.
+    void set_fused_pipeline(FusedPipeline fused_pipeline) {
+        fused_pipeline_ = std::move(fused_pipeline);
+    }
+
     void start() {
-        init();
+        initialize();
 
-        for (auto& component : component_list_)
-            component->before_updating();
+        if (!partitions_.empty() && (simulated_clock_ || replay_provider_))
+            RCLCPP_WARN(get_logger(), "Partitions always run in real time");
+        for (auto& partition : partitions_)
+            partition->start();
 
-        double update_rate;
-        if (!get_parameter("update_rate", update_rate))
-            throw std::runtime_error{"Unable to get parameter update_rate<double>"};
-        predefined_msg_provider_->set_update_rate(update_rate);
+        thread_ = std::thread{[update_rate = update_rate_, this]() {
+            using namespace std::chrono_literals;
+            trace::set_thread_name("control");
+            configure_control_thread();
 
-        thread_ = std::thread{[update_rate, this]() {
             const auto period = std::chrono::nanoseconds(
                 static_cast<long>(std::round(1'000'000'000.0 / update_rate)));
+
+            // Replay may run faster than real time, or as fast as possible when its rate is not
+            // positive. Simulated time never waits either.
+            double speed = replay_provider_ ? replay_rate_ : 1.0;
+            const bool free_running = simulated_clock_ || speed <= 0;
+            const auto pacing_period =
+                free_running ? period
+                             : std::chrono::nanoseconds(static_cast<long>(
+                                   std::round(static_cast<double>(period.count()) / speed)));
+            const auto spin_time = std::chrono::microseconds(realtime_spin_time_us_);
             auto next_iteration_time = std::chrono::steady_clock::now();
+            auto simulated_time      = next_iteration_time;
             while (rclcpp::ok()) {
-                predefined_msg_provider_->set_timestamp(next_iteration_time);
-                next_iteration_time += period;
-                for (const auto& component : updating_order_) {
-                    component->update();
+                auto tick_begin = std::chrono::steady_clock::now();
+                if (free_running)
+                    next_iteration_time = tick_begin;
+                auto wakeup_jitter = tick_begin - next_iteration_time;
+                wakeup_jitter_.record(wakeup_jitter);
+
+                auto timestamp = simulated_clock_ ? simulated_time : next_iteration_time;
+                simulated_time += period;
+                if (replay_provider_) {
+                    auto recorded_timestamp = replay_provider_->next_frame();
+                    if (!recorded_timestamp) {
+                        RCLCPP_INFO(get_logger(), "Replay finished after %zu ticks", tick_);
+                        rclcpp::shutdown();
+                        break;
+                    }
+                    timestamp = *recorded_timestamp;
                 }
-                std::this_thread::sleep_until(next_iteration_time);
+
+                predefined_msg_provider_->set_timestamp(timestamp);
+                next_iteration_time += pacing_period;
+                update_components();
+                if (recorder_)
+                    recorder_->record(tick_, timestamp);
+                if (staleness_monitor_)
+                    staleness_monitor_->check(timestamp);
+                if (shm_exporter_)
+                    shm_exporter_->publish(tick_, timestamp);
+                if (tick_++ == 0)
+                    report_startup_profile();
+
+                auto tick_end      = std::chrono::steady_clock::now();
+                auto tick_duration = tick_end - tick_begin;
+                tick_latency_.record(tick_duration);
+                if (trace::enabled()) [[unlikely]]
+                    trace::record(
+                        "tick", "executor", tick_begin.time_since_epoch().count(),
+                        tick_end.time_since_epoch().count());
+
+                // When a tick ends after the deadline of the next one, the following ticks are
+                // run back-to-back until the loop catches up again. Free-running ticks have no
+                // deadline to miss.
+                const bool late         = !free_running && tick_end > next_iteration_time;
+                size_t catch_up_backlog = 0;
+                if (late) {
+                    missed_deadline_count_.fetch_add(1, std::memory_order::relaxed);
+                    catch_up_backlog = (tick_end - next_iteration_time + pacing_period - 1ns)
+                                     / pacing_period;
+                    if (catch_up_backlog > max_catch_up_backlog_.load(std::memory_order::relaxed))
+                        max_catch_up_backlog_.store(
+                            catch_up_backlog, std::memory_order::relaxed);
+                }
+                if (budget_governor_)
+                    budget_governor_->check(late);
+                predefined_msg_provider_->set_tick_statistics(
+                    tick_duration, wakeup_jitter,
+                    missed_deadline_count_.load(std::memory_order::relaxed), catch_up_backlog);
+
+                if (!free_running)
+                    realtime::hybrid_sleep_until(next_iteration_time, spin_time);
             }
         }};
     }
 
+    // Resolves the dependency graph and prepares everything the control loop needs, without
+    // starting it. Called by start(), or directly by tools driving ticks with update_once().
+    void initialize() {
+        init_replay();
+        init();
+
+        for (auto& component : component_list_)
+            component->before_updating();
+        startup_profile_.mark("before_updating");
+
+        if (!get_parameter("update_rate", update_rate_))
+            throw std::runtime_error{"Unable to get parameter update_rate<double>"};
+        predefined_msg_provider_->set_update_rate(update_rate_);
+
+        init_clock();
+        init_realtime();
+        dump_updating_order();
+        init_update_entries(update_rate_);
+        init_trace();
+        init_parallel_scheduler();
+        init_fused_pipeline();
+        init_budget_governor();
+        init_recorder();
+        init_shm_exporter();
+        init_diagnostics();
+        startup_profile_.mark("executor setup");
+    }
+
+    StartupProfile& startup_profile() { return startup_profile_; }
+
+    // Resolved by initialize().
+    const std::vector<Component*>& updating_order() const { return updating_order_; }
+
+    // Runs on the thread spinning the ROS side, usually the main thread, once the control loop is
+    // started. `ros_spin.cpus` keeps it off the cores of the control loop, and `ros_spin.nice`
+    // lowers its priority among threads of the default policy.
+    void configure_spin_thread() {
+        std::vector<int64_t> cpus;
+        get_parameter("ros_spin.cpus", cpus);
+        if (!cpus.empty()
+            && !realtime::set_thread_affinity(
+                pthread_self(), std::vector<int>(cpus.begin(), cpus.end())))
+            RCLCPP_ERROR(get_logger(), "Unable to set cpu affinity of the spin thread");
+
+        int64_t nice = 0;
+        get_parameter("ros_spin.nice", nice);
+        if (nice != 0 && !realtime::set_this_thread_nice(static_cast<int>(nice)))
+            RCLCPP_ERROR(
+                get_logger(), "Unable to set nice value of the spin thread: %s",
+                std::strerror(errno));
+
+        get_parameter("ros_spin.callback_warn_us", callback_warn_us_);
+    }
+
+    // Runs a single tick on the calling thread, without pacing.
+    void update_once() {
+        predefined_msg_provider_->set_timestamp(std::chrono::steady_clock::now());
+        update_components();
+        tick_++;
+    }
+
 private:
+    void update_components() {
+        for (auto channel : incoming_channels_)
+            channel->receive();
+
+        if (parallel_scheduler_) {
+            parallel_scheduler_->update(tick_);
+        } else if (fused_pipeline_) {
+            fused_pipeline_->update(update_entries_.get(), tick_);
+        } else {
+            for (size_t i = 0; i < updating_order_.size(); i++)
+                update_entries_[i].update(tick_);
+        }
+
+        for (auto channel : outgoing_channels_)
+            channel->publish();
+    }
+
+    // Components read their parameters from the overrides given to the process (parameter files
+    // and `-p`), instead of from a node of their own.
+    void load_component_parameters() {
+        auto& global_arguments =
+            get_node_base_interface()->get_context()->get_rcl_context()->global_arguments;
+
+        rcl_params_t* parameters = nullptr;
+        if (rcl_arguments_get_param_overrides(&global_arguments, &parameters) != RCL_RET_OK)
+            throw std::runtime_error{"Unable to get parameter overrides"};
+        if (!parameters)
+            return;
+        RCPPUTILS_SCOPE_EXIT(rcl_yaml_node_struct_fini(parameters));
+
+        Component::parameter_map_ = rclcpp::parameter_map_from(parameters);
+    }
+
     void init() {
         updating_order_.clear();
+        init_partitions();
 
         auto output_map      = std::unordered_map<std::string, Component::OutputDeclaration*>{};
         auto user_output_map = std::map<std::string, const std::type_info&>{};
         for (const auto& component : component_list_) {
             component->dependency_count_ = 0;
             component->wanted_by_.clear();
+            component->input_versions_.clear();
             for (auto& output : component->output_list_) {
                 if (!output_map.emplace(output.name, &output).second)
                     throw std::runtime_error{"Duplicate names of output"};
@@ -86,10 +285,31 @@ private:
             component->before_pairing(user_output_map);
         }
 
+        // Consumers are listed in the order of component_list_, so that the updating order only
+        // depends on the order components are loaded in.
+        struct Binding {
+            Component* consumer;
+            const Component::InputDeclaration* input;
+            const Component::OutputDeclaration* output;
+            bool crossing;
+        };
+        auto successor_map    = std::unordered_map<Component*, std::vector<Component*>>{};
+        auto consumed_outputs = std::unordered_set<const Component::OutputDeclaration*>{};
+        auto bindings         = std::vector<Binding>{};
         for (const auto& component : component_list_) {
+            auto partition = partition_of(component.get());
             for (const auto& input : component->input_list_) {
+                // Components of a partition see the `/predefined/*` outputs of their partition.
+                const Component::OutputDeclaration* predefined_output = nullptr;
+                if (partition) {
+                    for (const auto& output : partition->predefined_msg_provider().output_list_) {
+                        if (output.name == input.name)
+                            predefined_output = &output;
+                    }
+                }
+
                 auto output_iter = output_map.find(input.name);
-                if (output_iter == output_map.end()) {
+                if (!predefined_output && output_iter == output_map.end()) {
                     if (!input.required)
                         continue;
 
@@ -101,7 +321,7 @@ private:
                     throw std::runtime_error{"Cannot find the corresponding output"};
                 }
 
-                const auto& output = *output_iter->second;
+                const auto& output = predefined_output ? *predefined_output : *output_iter->second;
                 if (input.type != output.type) {
                     RCLCPP_FATAL(get_logger(), "With message \"%s\":", input.name.c_str());
                     RCLCPP_FATAL(
@@ -114,22 +334,34 @@ private:
                     throw std::runtime_error{"Type not match"};
                 }
 
-                if (output.component->wanted_by_.emplace(component.get()).second)
-                    component->dependency_count_++;
+                // Outputs of another partition are read through a channel, and do not constrain
+                // the updating order.
+                bool crossing =
+                    !predefined_output && partition_of(output.component) != partition;
+                if (crossing && !output.byte_copyable && !output.copy_assign) {
+                    RCLCPP_FATAL(
+                        get_logger(),
+                        "Output \"%s\" is not copyable, but requested by component [%s] of another "
+                        "partition",
+                        output.name.c_str(), component->get_component_name().c_str());
+                    throw std::runtime_error{"Output cannot cross partitions"};
+                }
 
-                *input.pointer_to_data_pointer = output.data_pointer;
+                if (!predefined_output
+                    && output.component->wanted_by_.emplace(component.get()).second && !crossing) {
+                    component->dependency_count_++;
+                    successor_map[output.component].emplace_back(component.get());
+                }
+                consumed_outputs.emplace(&output);
+                bindings.emplace_back(component.get(), &input, &output, crossing);
             }
         }
 
-        RCLCPP_INFO(get_logger(), "Calculating component dependencies");
-        std::vector<Component*> independent_list;
-        for (const auto& component : component_list_) {
-            if (component->dependency_count_ == 0)
-                independent_list.emplace_back(component.get());
-        }
-        for (const auto& component : independent_list) {
-            append_updating_order(component);
-        }
+        startup_profile_.mark("pairing");
+
+        resolve_updating_order(successor_map);
+        RCLCPP_INFO(
+            get_logger(), "Resolved the updating order of %zu components", updating_order_.size());
 
         if (updating_order_.size() < component_list_.size()) {
             RCLCPP_FATAL(get_logger(), "Circular dependency found:");
@@ -140,7 +372,10 @@ private:
                 RCLCPP_FATAL(
                     get_logger(), "Component [%s]:", component->get_component_name().c_str());
                 for (const auto& input : component->input_list_) {
-                    const auto& output = output_map[input.name];
+                    auto output_iter = output_map.find(input.name);
+                    if (output_iter == output_map.end())
+                        continue;
+                    const auto& output = output_iter->second;
                     if (output->component->dependency_count_ == 0)
                         continue;
                     RCLCPP_FATAL(
@@ -150,28 +385,1097 @@ private:
             }
             throw std::runtime_error{"Circular dependency found"};
         }
+        startup_profile_.mark("dependency resolution");
+
+        prune_unreachable_components(consumed_outputs);
+
+        bool output_arena = true;
+        get_parameter("output_arena", output_arena);
+        if (output_arena)
+            place_outputs_in_arena();
+
+        std::vector<std::string> queued_names;
+        get_parameter("partition_channels.queued", queued_names);
+        auto queued_set = std::unordered_set<std::string>(queued_names.begin(), queued_names.end());
+        int64_t queue_capacity = 16;
+        get_parameter("partition_channels.queue_capacity", queue_capacity);
+
+        auto channel_map = std::map<
+            std::pair<const Component::OutputDeclaration*, Partition*>, PartitionChannel*>{};
+        for (const auto& [consumer, input, output, crossing] : bindings) {
+            void* data_pointer = output->data_pointer;
+            auto metadata      = output->metadata;
+            if (crossing) {
+                auto consumer_partition = partition_of(consumer);
+                auto& channel           = channel_map[{output, consumer_partition}];
+                if (!channel) {
+                    size_t capacity = queued_set.contains(output->name)
+                                        ? std::bit_ceil(static_cast<size_t>(
+                                              std::max<int64_t>(queue_capacity, 1)))
+                                        : 0;
+                    auto copy = output->byte_copyable
+                                  ? PartitionChannel::Copy{}
+                                  : PartitionChannel::Copy{
+                                        output->copy_construct, output->copy_assign,
+                                        output->destroy};
+                    channel = partition_channels_
+                                  .emplace_back(std::make_unique<PartitionChannel>(
+                                      output->data_pointer, output->metadata, output->size,
+                                      output->alignment, capacity, copy))
+                                  .get();
+                    if (auto producer_partition = partition_of(output->component))
+                        producer_partition->add_outgoing_channel(channel);
+                    else
+                        outgoing_channels_.emplace_back(channel);
+                    if (consumer_partition)
+                        consumer_partition->add_incoming_channel(channel);
+                    else
+                        incoming_channels_.emplace_back(channel);
+                }
+                data_pointer = channel->value();
+                metadata     = channel->metadata();
+            }
+            *input->pointer_to_data_pointer     = data_pointer;
+            *input->pointer_to_metadata_pointer = metadata;
+            consumer->input_versions_.emplace_back(&metadata->version);
+        }
+        init_staleness_monitor(consumed_outputs);
+        split_partitions();
+        startup_profile_.mark("pruning and output placement");
     }
 
-    void append_updating_order(Component* updatable_component) {
-        std::string space = "- ";
-        for (size_t i = dependency_recursive_level_; i-- > 0;)
-            space.append("    ");
+    // Components listed in `partition.<name>.components`, for every name in `partitions`, are
+    // updated by a thread of their own (see Partition). Partner components follow their owner, and
+    // may not be listed elsewhere. Everything else stays in the main control loop.
+    void init_partitions() {
+        std::vector<std::string> names;
+        get_parameter("partitions", names);
+        if (names.empty())
+            return;
+
+        auto component_map = std::unordered_map<std::string, Component*>{};
+        for (const auto& component : component_list_)
+            component_map.emplace(component->get_component_name(), component.get());
+
+        for (const auto& name : names) {
+            auto prefix = "partition." + name + ".";
+            auto config = Partition::Config{};
+            if (!get_parameter(prefix + "update_rate", config.update_rate)
+                || config.update_rate <= 0) {
+                throw std::runtime_error{
+                    "Unable to get parameter " + prefix + "update_rate<double>"};
+            }
+
+            int64_t cpu = -1, priority = 0, spin_time_us = 0;
+            get_parameter(prefix + "cpu", cpu);
+            get_parameter(prefix + "priority", priority);
+            get_parameter(prefix + "spin_time_us", spin_time_us);
+            config.cpu           = static_cast<int>(cpu);
+            config.fifo_priority = static_cast<int>(priority);
+            config.spin_time     = std::chrono::microseconds(spin_time_us);
+            auto& partition =
+                partitions_.emplace_back(std::make_unique<Partition>(name, config, get_logger()));
+
+            std::vector<std::string> component_names;
+            get_parameter(prefix + "components", component_names);
+            for (const auto& component_name : component_names) {
+                auto iter = component_map.find(component_name);
+                if (iter == component_map.end() || iter->second == predefined_msg_provider_.get()
+                    || iter->second == replay_provider_.get()) {
+                    RCLCPP_FATAL(
+                        get_logger(), "%scomponents: component [%s] cannot be partitioned",
+                        prefix.c_str(), component_name.c_str());
+                    throw std::runtime_error{"Cannot partition component"};
+                }
+                if (!partition_map_.emplace(iter->second, partition.get()).second) {
+                    RCLCPP_FATAL(
+                        get_logger(), "Component [%s] is listed in more than one partition",
+                        component_name.c_str());
+                    throw std::runtime_error{"Duplicate component in partitions"};
+                }
+            }
+        }
+
+        // Owners come before their partners in the component list.
+        auto listed_map = partition_map_;
+        for (const auto& component : component_list_) {
+            auto partition = partition_of(component.get());
+            for (const auto& partner : component->partner_component_list_) {
+                if (!listed_map.contains(partner.get())) {
+                    if (partition)
+                        partition_map_[partner.get()] = partition;
+                } else if (partition_of(partner.get()) != partition) {
+                    // Partners work on the devices and buffers of their owner.
+                    RCLCPP_FATAL(
+                        get_logger(), "Component [%s] is partitioned apart from its owner [%s]",
+                        partner->get_component_name().c_str(),
+                        component->get_component_name().c_str());
+                    throw std::runtime_error{"Partner component across partitions"};
+                }
+            }
+        }
+
+        auto shared_state_map = std::unordered_map<std::string, Component*>{};
+        for (const auto& component : component_list_) {
+            for (const auto& key : component->shared_state_list_) {
+                auto [iter, inserted] = shared_state_map.try_emplace(key, component.get());
+                if (!inserted && partition_of(iter->second) != partition_of(component.get())) {
+                    RCLCPP_FATAL(
+                        get_logger(),
+                        "Components [%s] and [%s] share state \"%s\" across partitions",
+                        iter->second->get_component_name().c_str(),
+                        component->get_component_name().c_str(), key.c_str());
+                    throw std::runtime_error{"Shared state across partitions"};
+                }
+            }
+        }
+    }
+
+    // nullptr for components of the main control loop.
+    Partition* partition_of(const Component* component) const {
+        auto iter = partition_map_.find(const_cast<Component*>(component));
+        return iter == partition_map_.end() ? nullptr : iter->second;
+    }
+
+    // Hands the components of each partition, in updating order, over to their partition.
+    void split_partitions() {
+        if (partitions_.empty())
+            return;
+
+        auto main_order      = std::vector<Component*>{};
+        auto partition_order = std::unordered_map<Partition*, std::vector<Component*>>{};
+        for (const auto& component : updating_order_) {
+            if (auto partition = partition_of(component))
+                partition_order[partition].emplace_back(component);
+            else
+                main_order.emplace_back(component);
+        }
+        updating_order_ = std::move(main_order);
+        last_partition_missed_deadline_counts_.assign(partitions_.size(), 0);
+
+        for (auto& partition : partitions_) {
+            partition->set_updating_order(std::move(partition_order[partition.get()]));
+            RCLCPP_INFO(
+                get_logger(), "Partition %s: %zu component(s) at %.1f Hz",
+                partition->name().c_str(), partition->updating_order().size(),
+                partition->config().update_rate);
+        }
         RCLCPP_INFO(
-            get_logger(), "%s%s", space.c_str(), updatable_component->get_component_name().c_str());
-        updating_order_.emplace_back(updatable_component);
+            get_logger(), "%zu channel(s) between partitions", partition_channels_.size());
+    }
 
-        for (auto& component : component_list_) {
-            if (updatable_component->wanted_by_.contains(component.get())) {
-                if (--component->dependency_count_ == 0) {
-                    dependency_recursive_level_++;
-                    append_updating_order(component.get());
-                    dependency_recursive_level_--;
+    // Watches the timestamps of consumed outputs (all of them, or those listed in
+    // `staleness.outputs`) when `staleness.max_age` is positive.
+    void init_staleness_monitor(
+        const std::unordered_set<const Component::OutputDeclaration*>& consumed_outputs) {
+        double max_age = 0;
+        get_parameter("staleness.max_age", max_age);
+        if (max_age <= 0)
+            return;
+        std::vector<std::string> selected_names;
+        get_parameter("staleness.outputs", selected_names);
+        auto selected_set =
+            std::unordered_set<std::string>(selected_names.begin(), selected_names.end());
+
+        staleness_monitor_ = std::make_unique<StalenessMonitor>();
+        for (const auto& component : component_list_) {
+            if (partition_of(component.get()))
+                continue;
+            for (const auto& output : component->output_list_) {
+                if (!consumed_outputs.contains(&output))
+                    continue;
+                if (!selected_set.empty() && !selected_set.contains(output.name))
+                    continue;
+                staleness_monitor_->add(
+                    output.name, output.metadata,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::duration<double>(max_age)));
+            }
+        }
+    }
+
+    // Depth-first topological sort in O(V+E): a component is appended once its last producer is,
+    // and its consumers are visited right after it.
+    void resolve_updating_order(
+        const std::unordered_map<Component*, std::vector<Component*>>& successor_map) {
+        static const auto no_successors = std::vector<Component*>{};
+        struct Frame {
+            const std::vector<Component*>* successors;
+            size_t next = 0;
+        };
+        auto stack  = std::vector<Frame>{};
+        auto append = [&](Component* component) {
+            RCLCPP_DEBUG(
+                get_logger(), "%*s- %s", static_cast<int>(stack.size() * 4), "",
+                component->get_component_name().c_str());
+            updating_order_.emplace_back(component);
+
+            auto iter = successor_map.find(component);
+            stack.push_back({iter == successor_map.end() ? &no_successors : &iter->second});
+        };
+
+        auto independent_list = std::vector<Component*>{};
+        for (const auto& component : component_list_) {
+            if (component->dependency_count_ == 0)
+                independent_list.emplace_back(component.get());
+        }
+        for (const auto& component : independent_list) {
+            append(component);
+            while (!stack.empty()) {
+                auto& frame = stack.back();
+                if (frame.next == frame.successors->size()) {
+                    stack.pop_back();
+                    continue;
                 }
+                auto successor = (*frame.successors)[frame.next++];
+                if (--successor->dependency_count_ == 0)
+                    append(successor);
             }
         }
-    };
+    }
+
+    // Runs on the control thread right after the first tick.
+    void report_startup_profile() {
+        startup_profile_.mark("first tick");
+
+        auto to_ms = [](StartupProfile::Clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+        RCLCPP_INFO(
+            get_logger(), "First tick %.1f ms after startup:", to_ms(startup_profile_.total()));
+        for (const auto& phase : startup_profile_.phases()) {
+            RCLCPP_INFO(
+                get_logger(), "    %-30s %8.1f ms", phase.name.c_str(), to_ms(phase.duration));
+        }
+        for (const auto& load : startup_profile_.slowest_component_loads(3))
+            RCLCPP_INFO(
+                get_logger(), "    Loading [%s] took %.1f ms", load.name.c_str(),
+                to_ms(load.duration));
+    }
+
+    // Moves the outputs into one contiguous block, in updating order. Outputs of a component are
+    // sorted by their first consumer and start on their own cache line, so that components
+    // updated on different workers never write to the same line.
+    void place_outputs_in_arena() {
+        constexpr size_t cache_line_size = 64;
+        auto align_up = [](size_t offset, size_t alignment) {
+            return (offset + alignment - 1) / alignment * alignment;
+        };
+
+        auto first_consumer_map = std::unordered_map<std::string, size_t>{};
+        for (size_t i = 0; i < updating_order_.size(); i++) {
+            for (const auto& input : updating_order_[i]->input_list_)
+                first_consumer_map.try_emplace(input.name, i);
+        }
+
+        auto placements = std::vector<std::pair<Component::OutputDeclaration*, size_t>>{};
+        size_t arena_size = 0;
+        for (const auto& component : updating_order_) {
+            auto outputs = std::vector<Component::OutputDeclaration*>{};
+            for (auto& output : component->output_list_) {
+                if (output.relocate)
+                    outputs.emplace_back(&output);
+            }
+            if (outputs.empty())
+                continue;
+
+            auto first_consumer = [&first_consumer_map](const auto* output) {
+                auto iter = first_consumer_map.find(output->name);
+                return iter == first_consumer_map.end() ? static_cast<size_t>(-1) : iter->second;
+            };
+            std::stable_sort(outputs.begin(), outputs.end(), [&](auto lhs, auto rhs) {
+                return first_consumer(lhs) < first_consumer(rhs);
+            });
+
+            arena_size = align_up(arena_size, cache_line_size);
+            for (auto output : outputs) {
+                arena_size = align_up(arena_size, output->alignment);
+                placements.emplace_back(output, arena_size);
+                arena_size += output->size;
+            }
+        }
+        if (placements.empty())
+            return;
+
+        arena_size = align_up(arena_size, cache_line_size);
+        auto arena = std::shared_ptr<void>(
+            ::operator new(arena_size, std::align_val_t{cache_line_size}), [](void* pointer) {
+                ::operator delete(pointer, std::align_val_t{cache_line_size});
+            });
+        auto arena_begin = static_cast<std::byte*>(arena.get());
+
+        for (auto [output, offset] : placements) {
+            output->data_pointer = output->relocate(output->interface, arena_begin + offset);
+            output->component->output_arena_ = arena;
+        }
+        RCLCPP_INFO(
+            get_logger(), "Placed %zu outputs (%zu bytes) in the output arena", placements.size(),
+            arena_size);
+    }
+
+    // Walks the graph backwards from the sinks: components without outputs, components marked as
+    // sinks, and those listed in the parameter `sink_components`. Whatever is not reached only
+    // produces outputs nobody uses.
+    void prune_unreachable_components(
+        const std::unordered_set<const Component::OutputDeclaration*>& consumed_outputs) {
+        bool prune = false;
+        get_parameter("prune_unreachable_components", prune);
+        std::vector<std::string> sink_names;
+        get_parameter("sink_components", sink_names);
+        auto sink_name_set = std::unordered_set<std::string>(sink_names.begin(), sink_names.end());
+
+        auto producer_map = std::unordered_map<Component*, std::vector<Component*>>{};
+        for (const auto& component : component_list_) {
+            for (const auto& consumer : component->wanted_by_)
+                producer_map[consumer].emplace_back(component.get());
+
+            // The owner of a partner component usually does the work its partner relies on.
+            for (const auto& partner : component->partner_component_list_)
+                producer_map[partner.get()].emplace_back(component.get());
+        }
+
+        auto reachable = std::unordered_set<Component*>{};
+        auto pending   = std::vector<Component*>{};
+        for (const auto& component : component_list_) {
+            if (component->output_list_.empty() || component->is_sink_
+                || sink_name_set.contains(component->get_component_name())
+                || component == predefined_msg_provider_) {
+                if (reachable.emplace(component.get()).second)
+                    pending.emplace_back(component.get());
+            }
+        }
+        while (!pending.empty()) {
+            auto component = pending.back();
+            pending.pop_back();
+            for (const auto& producer : producer_map[component]) {
+                if (reachable.emplace(producer).second)
+                    pending.emplace_back(producer);
+            }
+        }
+
+        for (const auto& component : component_list_) {
+            for (const auto& output : component->output_list_) {
+                if (!consumed_outputs.contains(&output))
+                    RCLCPP_DEBUG(
+                        get_logger(), "Output \"%s\" of component [%s] is never consumed",
+                        output.name.c_str(), component->get_component_name().c_str());
+            }
+        }
+
+        size_t unreachable_count = 0;
+        for (const auto& component : updating_order_) {
+            if (reachable.contains(component))
+                continue;
+            unreachable_count++;
+            RCLCPP_WARN(
+                get_logger(), "Component [%s] does not contribute to any sink%s",
+                component->get_component_name().c_str(), prune ? ", pruned" : "");
+        }
+
+        if (prune && unreachable_count) {
+            std::erase_if(updating_order_, [&reachable](Component* component) {
+                return !reachable.contains(component);
+            });
+        }
+    }
+
+    // Feeds the channels of a data log recorded with `record.path` into the inputs they match.
+    // Outputs produced by a loaded component win over recorded ones unless listed explicitly.
+    void init_replay() {
+        std::string path;
+        get_parameter("replay.path", path);
+        if (path.empty())
+            return;
+        get_parameter("replay.rate", replay_rate_);
+        std::vector<std::string> selected_names;
+        get_parameter("replay.outputs", selected_names);
+        auto selected_set =
+            std::unordered_set<std::string>(selected_names.begin(), selected_names.end());
+
+        Component::initializing_component_name = "replay_provider";
+        replay_provider_ = std::make_shared<ReplayProvider>(path);
+
+        auto produced_set = std::unordered_set<std::string>{};
+        auto input_map    = std::unordered_map<std::string, const std::type_info*>{};
+        for (const auto& component : component_list_) {
+            for (const auto& output : component->output_list_)
+                produced_set.emplace(output.name);
+            for (const auto& input : component->input_list_)
+                input_map.emplace(input.name, &input.type);
+        }
+
+        size_t replayed_count = 0;
+        for (const auto& channel : replay_provider_->channels()) {
+            if (!selected_set.empty() && !selected_set.contains(channel.name))
+                continue;
+            if (produced_set.contains(channel.name)) {
+                if (selected_set.empty())
+                    continue;
+                RCLCPP_FATAL(
+                    get_logger(), "Replayed output \"%s\" is also produced by a component",
+                    channel.name.c_str());
+                throw std::runtime_error{"Duplicate names of output"};
+            }
+
+            auto input_iter = input_map.find(channel.name);
+            if (input_iter == input_map.end())
+                continue;
+            const auto& type = *input_iter->second;
+            if (channel.type != type.name()) {
+                RCLCPP_FATAL(
+                    get_logger(), "Recorded output \"%s\" has type \"%s\", but \"%s\" is requested",
+                    channel.name.c_str(), channel.type.c_str(), type.name());
+                throw std::runtime_error{"Type not match"};
+            }
+
+            const auto& replayed = replay_provider_->add_channel(channel);
+            auto& output = replay_provider_->output_list_.emplace_back(
+                type, channel.name, replayed.storage.get(), replay_provider_.get(), channel.size,
+                alignof(std::max_align_t), true);
+            output.metadata = &replayed.metadata;
+            replayed_count++;
+        }
+
+        RCLCPP_INFO(
+            get_logger(), "Replaying %zu output(s) over %zu frames from %s", replayed_count,
+            replay_provider_->frame_count(), path.c_str());
+        add_component(replay_provider_);
+    }
+
+    // Byte-copyable outputs listed in the parameter `parameter_name`, or all of them when the list
+    // is empty. Listed outputs that cannot be used are reported.
+    std::vector<const Component::OutputDeclaration*>
+        select_byte_copyable_outputs(const std::string& parameter_name) {
+        std::vector<std::string> selected_names;
+        get_parameter(parameter_name, selected_names);
+        auto selected_set =
+            std::unordered_set<std::string>(selected_names.begin(), selected_names.end());
+
+        auto outputs = std::vector<const Component::OutputDeclaration*>{};
+        for (const auto& component : component_list_) {
+            for (const auto& output : component->output_list_) {
+                if (!selected_names.empty() && !selected_set.erase(output.name))
+                    continue;
+                if (!output.byte_copyable) {
+                    if (!selected_names.empty())
+                        RCLCPP_WARN(
+                            get_logger(), "%s: output \"%s\" is not byte-copyable, ignored",
+                            parameter_name.c_str(), output.name.c_str());
+                    continue;
+                }
+                if (partition_of(component.get())) {
+                    if (!selected_names.empty())
+                        RCLCPP_WARN(
+                            get_logger(), "%s: output \"%s\" is produced in a partition, ignored",
+                            parameter_name.c_str(), output.name.c_str());
+                    continue;
+                }
+                outputs.emplace_back(&output);
+            }
+        }
+        for (const auto& name : selected_set) {
+            RCLCPP_WARN(
+                get_logger(), "%s: output \"%s\" does not exist", parameter_name.c_str(),
+                name.c_str());
+        }
+        return outputs;
+    }
+
+    // Records byte-copyable outputs (all of them, or those listed in `record.outputs`) every tick.
+    // Must run after the outputs are placed in their final location.
+    void init_recorder() {
+        std::string path;
+        get_parameter("record.path", path);
+        if (path.empty())
+            return;
+
+        auto sources = std::vector<data_log::Writer::Source>{};
+        for (const auto& output : select_byte_copyable_outputs("record.outputs"))
+            sources.emplace_back(
+                output->name, output->type.name(), output->size, output->data_pointer);
+
+        RCLCPP_INFO(get_logger(), "Recording %zu output(s) to %s", sources.size(), path.c_str());
+        recorder_ = std::make_unique<data_log::Writer>(path, std::move(sources));
+    }
+
+    // Mirrors byte-copyable outputs (all of them, or those listed in `shm_export.outputs`) into the
+    // shared-memory segment `shm_export.name` every tick.
+    void init_shm_exporter() {
+        std::string name;
+        get_parameter("shm_export.name", name);
+        if (name.empty())
+            return;
+
+        auto sources = std::vector<ShmExporter::Source>{};
+        for (const auto& output : select_byte_copyable_outputs("shm_export.outputs"))
+            sources.emplace_back(
+                output->name, output->type.name(), output->size, output->data_pointer);
+
+        shm_exporter_ = std::make_unique<ShmExporter>(name, sources);
+        RCLCPP_INFO(
+            get_logger(), "Exporting %zu output(s) to shared memory %s", sources.size(),
+            name.c_str());
+    }
+
+    // Writes the timeline of ticks, component updates and whatever else is instrumented with
+    // rmcs_executor/trace.hpp to `trace.path`. Recording follows the parameter `trace.enabled`,
+    // which may be changed at runtime.
+    void init_trace() {
+        std::string path;
+        get_parameter("trace.path", path);
+        if (path.empty())
+            return;
+
+        double flush_period = 1.0;
+        get_parameter("trace.flush_period", flush_period);
+        trace_writer_ = std::make_unique<TraceWriter>(
+            path, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::duration<double>(flush_period)));
+        // Before the workers, the partitions and the control thread are started.
+        trace::reserve_named_thread_buffers();
+
+        trace_parameter_subscriber_ = std::make_unique<rclcpp::ParameterEventHandler>(this);
+        trace_parameter_callback_   = trace_parameter_subscriber_->add_parameter_callback(
+            "trace.enabled", [this](const rclcpp::Parameter& parameter) {
+                trace::set_enabled(parameter.as_bool());
+                RCLCPP_INFO(
+                    get_logger(), "Tracing %s", parameter.as_bool() ? "enabled" : "disabled");
+            });
+
+        bool enabled = false;
+        if (!get_parameter("trace.enabled", enabled))
+            declare_parameter<bool>("trace.enabled", false);
+        trace::set_enabled(enabled);
+        RCLCPP_INFO(
+            get_logger(), "Tracing to %s, currently %s", path.c_str(),
+            enabled ? "enabled" : "disabled");
+    }
+
+    // Writes the resolved updating order, one component per line, to `updating_order_path`. This
+    // is what a fused pipeline is generated from.
+    void dump_updating_order() {
+        std::string path;
+        get_parameter("updating_order_path", path);
+        if (path.empty())
+            return;
+
+        std::ofstream file{path};
+        for (const auto& component : updating_order_)
+            file << component->get_component_name() << '\n';
+        if (!file)
+            throw std::runtime_error{"Unable to write the updating order to " + path};
+        RCLCPP_INFO(get_logger(), "Updating order written to %s", path.c_str());
+    }
 
-    rclcpp::executors::SingleThreadedExecutor& rcl_executor_;
+    // A fused pipeline calls components by position, so it is only usable if it was generated from
+    // exactly the order resolved here.
+    void init_fused_pipeline() {
+        if (!fused_pipeline_)
+            return;
+
+        if (parallel_scheduler_) {
+            RCLCPP_WARN(get_logger(), "Fused pipeline ignored when updating in parallel");
+            fused_pipeline_.reset();
+            return;
+        }
+
+        const auto& baked_order = fused_pipeline_->updating_order;
+        const auto& baked_types = fused_pipeline_->types;
+        bool matched            = baked_order.size() == updating_order_.size();
+        matched                 = matched && baked_types.size() == updating_order_.size();
+        for (size_t i = 0; matched && i < baked_order.size(); i++) {
+            matched = baked_order[i] == updating_order_[i]->get_component_name()
+                   && (!baked_types[i] || *baked_types[i] == typeid(*updating_order_[i]));
+        }
+        if (!matched) {
+            RCLCPP_FATAL(
+                get_logger(),
+                "The fused pipeline was generated for another configuration (baked, resolved):");
+            for (size_t i = 0; i < std::max(baked_order.size(), updating_order_.size()); i++) {
+                RCLCPP_FATAL(
+                    get_logger(), "    %-40s %s",
+                    i < baked_order.size() ? baked_order[i].c_str() : "-",
+                    i < updating_order_.size() ? updating_order_[i]->get_component_name().c_str()
+                                               : "-");
+            }
+            RCLCPP_FATAL(
+                get_logger(),
+                "Regenerate it from the order written with the parameter updating_order_path.");
+            throw std::runtime_error{"Fused pipeline not match"};
+        }
+        RCLCPP_INFO(
+            get_logger(), "Updating %zu components through the fused pipeline", baked_order.size());
+        if (!fused_pipeline_->timed)
+            RCLCPP_INFO(
+                get_logger(),
+                "The fused pipeline is untimed: no update latencies, budgets or trace events");
+    }
+
+    // Components may be given a time budget with `budget.<component>.time_us`, and be marked as
+    // not critical with `budget.<component>.criticality: best_effort`. Best-effort components are
+    // slowed down, then skipped, while budgets are overrun or ticks are late (see BudgetGovernor).
+    void init_budget_governor() {
+        const std::string budget_group  = "budget";
+        const std::string budget_prefix = budget_group + ".";
+
+        auto config = BudgetGovernor::Config{};
+        auto get_size_parameter = [this](const std::string& name, size_t& value) {
+            int64_t parameter;
+            if (get_parameter(name, parameter))
+                value = static_cast<size_t>(std::max<int64_t>(parameter, 1));
+        };
+        get_size_parameter("degradation.window_ticks", config.window_ticks);
+        get_size_parameter("degradation.overrun_ticks", config.overrun_ticks);
+        get_size_parameter("degradation.recovery_ticks", config.recovery_ticks);
+        get_size_parameter("degradation.divisor", config.divisor);
+
+        auto governor            = std::make_unique<BudgetGovernor>(config);
+        size_t budgeted_count    = 0;
+        size_t best_effort_count = 0;
+        auto component_names     = std::unordered_set<std::string>{};
+        for (size_t i = 0; i < updating_order_.size(); i++) {
+            const auto& name = updating_order_[i]->get_component_name();
+            auto& entry      = update_entries_[i];
+            component_names.emplace(name);
+
+            double budget_us = 0;
+            if (get_parameter(budget_prefix + name + ".time_us", budget_us) && budget_us > 0) {
+                entry.budget = std::chrono::nanoseconds(static_cast<int64_t>(budget_us * 1e3));
+                governor->add_budgeted(name, entry);
+                budgeted_count++;
+            }
+
+            std::string criticality = "critical";
+            get_parameter(budget_prefix + name + ".criticality", criticality);
+            if (criticality == "best_effort") {
+                governor->add_best_effort(entry);
+                best_effort_count++;
+            } else if (criticality != "critical") {
+                throw std::runtime_error{
+                    "Unknown criticality \"" + criticality + "\" of component " + name};
+            }
+        }
+
+        for (const auto& parameter_name : list_parameters({budget_group}, 0).names) {
+            auto name = parameter_name.substr(
+                budget_prefix.size(), parameter_name.rfind('.') - budget_prefix.size());
+            if (!component_names.contains(name)) {
+                RCLCPP_WARN(
+                    get_logger(), "%s: component [%s] is not updated by the main control loop",
+                    parameter_name.c_str(), name.c_str());
+            }
+        }
+
+        if (budgeted_count == 0 && best_effort_count == 0)
+            return;
+        budget_governor_ = std::move(governor);
+        RCLCPP_INFO(
+            get_logger(), "%zu component(s) with a time budget, %zu best-effort component(s)",
+            budgeted_count, best_effort_count);
+    }
+
+    void init_update_entries(double update_rate) {
+        update_entries_ = std::make_unique<UpdateEntry[]>(updating_order_.size());
+        for (size_t i = 0; i < updating_order_.size(); i++) {
+            update_entries_[i].component = updating_order_[i];
+            init_update_entry(update_entries_[i], update_rate);
+        }
+
+        for (auto& partition : partitions_) {
+            for (size_t i = 0; i < partition->updating_order().size(); i++)
+                init_update_entry(partition->update_entries()[i], partition->config().update_rate);
+        }
+    }
+
+    void init_update_entry(UpdateEntry& entry, double update_rate) {
+        auto component = entry.component;
+
+        // All divisors share phase zero, so components of different rates updated on the same
+        // tick still follow the dependency order.
+        auto divisor = component->update_divisor_;
+        if (component->update_period_ != std::chrono::nanoseconds::zero()) {
+            divisor = static_cast<size_t>(std::round(
+                std::chrono::duration<double>(component->update_period_).count() * update_rate));
+        }
+        entry.divisor = std::max<size_t>(divisor, 1);
+        if (component->lazy_update_) {
+            entry.lazy           = true;
+            entry.input_versions = component->input_versions_;
+            entry.last_input_versions.assign(
+                entry.input_versions.size(), static_cast<size_t>(-1));
+        }
+
+        if (entry.divisor != 1) {
+            RCLCPP_INFO(
+                get_logger(), "Component [%s] updates every %zu ticks (%.2f Hz)",
+                component->get_component_name().c_str(), entry.divisor,
+                update_rate / static_cast<double>(entry.divisor));
+        }
+    }
+
+    void init_parallel_scheduler() {
+        int64_t worker_count = 0;
+        get_parameter("parallel_workers", worker_count);
+        if (worker_count <= 0)
+            return;
+
+        std::vector<int64_t> worker_cpus;
+        get_parameter("parallel_worker_cpus", worker_cpus);
+
+        auto index_map = std::unordered_map<Component*, size_t>{};
+        for (size_t i = 0; i < updating_order_.size(); i++)
+            index_map.emplace(updating_order_[i], i);
+
+        auto nodes = std::vector<ParallelScheduler::Node>(updating_order_.size());
+        auto add_edge = [&nodes](size_t from, size_t to) {
+            auto& successors = nodes[from].successors;
+            if (std::find(successors.begin(), successors.end(), to) != successors.end())
+                return;
+            successors.emplace_back(to);
+            nodes[to].predecessor_count++;
+        };
+
+        auto last_holder_map = std::unordered_map<std::string, size_t>{};
+        for (size_t i = 0; i < updating_order_.size(); i++) {
+            auto component = updating_order_[i];
+            nodes[i].entry = &update_entries_[i];
+            for (const auto& dependent : component->wanted_by_) {
+                // Pruned dependents are not part of the updating order.
+                auto iter = index_map.find(dependent);
+                if (iter != index_map.end())
+                    add_edge(i, iter->second);
+            }
+
+            // Partners rely on the work of their owner (e.g. a hardware command on the feedback
+            // of its devices) without necessarily consuming any of its outputs. Ordered as in the
+            // serial loop, which keeps the graph acyclic.
+            for (const auto& partner : component->partner_component_list_) {
+                auto iter = index_map.find(partner.get());
+                if (iter != index_map.end())
+                    add_edge(std::min(i, iter->second), std::max(i, iter->second));
+            }
+
+            // Chain components sharing state in their serial order, which keeps the graph
+            // acyclic and the behavior identical to the serial loop.
+            for (const auto& key : component->shared_state_list_) {
+                auto [iter, inserted] = last_holder_map.try_emplace(key, i);
+                if (!inserted) {
+                    add_edge(iter->second, i);
+                    iter->second = i;
+                }
+            }
+        }
+
+        auto cpus = std::vector<int>(worker_cpus.begin(), worker_cpus.end());
+        parallel_scheduler_ = std::make_unique<ParallelScheduler>(
+            std::move(nodes), static_cast<size_t>(worker_count), cpus,
+            static_cast<int>(realtime_priority_), get_logger());
+        RCLCPP_INFO(
+            get_logger(), "Updating components in parallel with %ld extra worker(s)", worker_count);
+    }
+
+    // With `clock: simulated`, every tick advances /predefined/timestamp by exactly one period and
+    // the loop never sleeps, which runs the graph as fast as the components allow.
+    void init_clock() {
+        std::string clock = "steady";
+        get_parameter("clock", clock);
+        if (clock == "simulated") {
+            simulated_clock_ = true;
+            RCLCPP_INFO(get_logger(), "Using simulated time");
+        } else if (clock != "steady") {
+            RCLCPP_FATAL(get_logger(), "Unknown clock \"%s\"", clock.c_str());
+            throw std::runtime_error{"Unknown clock"};
+        }
+    }
+
+    void init_realtime() {
+        get_parameter("realtime.priority", realtime_priority_);
+        get_parameter("realtime.cpu", realtime_cpu_);
+        get_parameter("realtime.spin_time_us", realtime_spin_time_us_);
+
+        bool lock_memory = false;
+        get_parameter("realtime.lock_memory", lock_memory);
+        if (lock_memory) {
+            constexpr size_t heap_prefault_size = 64 * 1024 * 1024;
+            if (realtime::lock_memory(heap_prefault_size))
+                RCLCPP_INFO(get_logger(), "Memory locked and pre-faulted");
+            else
+                RCLCPP_ERROR(get_logger(), "Unable to lock memory: %s", std::strerror(errno));
+        }
+    }
+
+    // Runs on the control thread itself, before the first tick.
+    void configure_control_thread() {
+        if (realtime_cpu_ >= 0
+            && !realtime::set_thread_affinity(pthread_self(), static_cast<int>(realtime_cpu_)))
+            RCLCPP_ERROR(get_logger(), "Unable to pin control thread to cpu %ld", realtime_cpu_);
+
+        if (realtime_priority_ > 0) {
+            if (realtime::set_thread_fifo_priority(
+                    pthread_self(), static_cast<int>(realtime_priority_)))
+                RCLCPP_INFO(
+                    get_logger(), "Control thread running with SCHED_FIFO priority %ld",
+                    realtime_priority_);
+            else
+                RCLCPP_ERROR(
+                    get_logger(), "Unable to set SCHED_FIFO priority: %s", std::strerror(errno));
+        }
+
+        realtime::prefault_stack();
+    }
+
+    void init_diagnostics() {
+        double diagnostics_period = 1.0;
+        get_parameter("diagnostics_period", diagnostics_period);
+        if (diagnostics_period <= 0)
+            return;
+
+        diagnostics_publisher_ = create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+            "/diagnostics", rclcpp::QoS{10});
+        diagnostics_timer_ = create_wall_timer(
+            std::chrono::duration<double>(diagnostics_period), [this]() { publish_diagnostics(); });
+    }
+
+    void publish_diagnostics() {
+        using diagnostic_msgs::msg::DiagnosticStatus;
+        using diagnostic_msgs::msg::KeyValue;
+
+        auto add_value = [](DiagnosticStatus& status, const std::string& key, auto value) {
+            KeyValue key_value;
+            key_value.key   = key;
+            key_value.value = std::to_string(value);
+            status.values.emplace_back(std::move(key_value));
+        };
+        auto make_latency_status = [&](const std::string& name, LatencyHistogram& latency) {
+            auto to_microseconds = [](std::chrono::nanoseconds duration) {
+                return std::chrono::duration<double, std::micro>(duration).count();
+            };
+            auto summary = latency.collect();
+
+            DiagnosticStatus status;
+            status.level       = DiagnosticStatus::OK;
+            status.name        = std::string{get_name()} + ": " + name;
+            status.hardware_id = get_name();
+            status.message     = "OK";
+            add_value(status, "count", summary.count);
+            add_value(status, "p50_us", to_microseconds(summary.p50));
+            add_value(status, "p99_us", to_microseconds(summary.p99));
+            add_value(status, "max_us", to_microseconds(summary.max));
+            return status;
+        };
+
+        diagnostic_msgs::msg::DiagnosticArray message;
+        message.header.stamp = now();
+
+        auto tick_status           = make_latency_status("tick", tick_latency_);
+        auto missed_deadline_count = missed_deadline_count_.load(std::memory_order::relaxed);
+        add_value(tick_status, "missed_deadline_count", missed_deadline_count);
+        add_value(
+            tick_status, "max_catch_up_backlog",
+            max_catch_up_backlog_.exchange(0, std::memory_order::relaxed));
+        if (missed_deadline_count != last_missed_deadline_count_) {
+            tick_status.level   = DiagnosticStatus::WARN;
+            auto newly_missed   = missed_deadline_count - last_missed_deadline_count_;
+            tick_status.message = std::to_string(newly_missed) + " deadline(s) missed";
+        }
+        last_missed_deadline_count_ = missed_deadline_count;
+        message.status.emplace_back(std::move(tick_status));
+        message.status.emplace_back(make_latency_status("wakeup_jitter", wakeup_jitter_));
+
+        if (recorder_) {
+            DiagnosticStatus record_status;
+            auto dropped_count        = recorder_->dropped_count();
+            record_status.level       = DiagnosticStatus::OK;
+            record_status.name        = std::string{get_name()} + ": record";
+            record_status.hardware_id = get_name();
+            record_status.message     = "OK";
+            add_value(record_status, "dropped_frame_count", dropped_count);
+            if (auto error = recorder_->error()) {
+                record_status.level   = DiagnosticStatus::ERROR;
+                record_status.message = std::string{"Recording stopped: "} + error;
+            } else if (dropped_count != last_dropped_frame_count_) {
+                record_status.level   = DiagnosticStatus::WARN;
+                record_status.message = "Frames dropped, the writer cannot keep up";
+            }
+            last_dropped_frame_count_ = dropped_count;
+            message.status.emplace_back(std::move(record_status));
+        }
+
+        if (trace_writer_) {
+            DiagnosticStatus trace_status;
+            auto dropped_count       = trace_writer_->dropped_count();
+            trace_status.level       = DiagnosticStatus::OK;
+            trace_status.name        = std::string{get_name()} + ": trace";
+            trace_status.hardware_id = get_name();
+            trace_status.message     = trace::enabled() ? "Enabled" : "Disabled";
+            add_value(trace_status, "dropped_event_count", dropped_count);
+            if (dropped_count != last_dropped_event_count_) {
+                trace_status.level   = DiagnosticStatus::WARN;
+                trace_status.message = "Events dropped, lower trace.flush_period";
+            }
+            last_dropped_event_count_ = dropped_count;
+            message.status.emplace_back(std::move(trace_status));
+        }
+
+        if (budget_governor_) {
+            DiagnosticStatus budget_status;
+            budget_status.level       = DiagnosticStatus::OK;
+            budget_status.name        = std::string{get_name()} + ": budget";
+            budget_status.hardware_id = get_name();
+            budget_status.message     = "OK";
+
+            auto level         = budget_governor_->level();
+            auto degrade_count = budget_governor_->degrade_count();
+            add_value(budget_status, "level", static_cast<int>(level));
+            add_value(budget_status, "degrade_count", degrade_count);
+            for (auto& entry : budget_governor_->budgeted_entries()) {
+                auto overrun_count = entry.overrun_count.load(std::memory_order::relaxed);
+                if (overrun_count == entry.reported_overrun_count)
+                    continue;
+                add_value(
+                    budget_status, entry.name + " overruns",
+                    overrun_count - entry.reported_overrun_count);
+                entry.reported_overrun_count = overrun_count;
+            }
+
+            if (level != BudgetGovernor::Level::NORMAL) {
+                budget_status.level   = DiagnosticStatus::WARN;
+                budget_status.message = level == BudgetGovernor::Level::SKIPPED
+                                          ? "Best-effort components skipped"
+                                          : "Best-effort components at a reduced rate";
+            }
+            if (level != last_budget_level_ || degrade_count != last_degrade_count_) {
+                RCLCPP_WARN(
+                    get_logger(), "Time budgets: %s (%zu degradation(s) so far)",
+                    budget_status.message.c_str(), degrade_count);
+            }
+            last_budget_level_  = level;
+            last_degrade_count_ = degrade_count;
+            message.status.emplace_back(std::move(budget_status));
+        }
+
+        if (staleness_monitor_) {
+            DiagnosticStatus staleness_status;
+            staleness_status.level       = DiagnosticStatus::OK;
+            staleness_status.name        = std::string{get_name()} + ": staleness";
+            staleness_status.hardware_id = get_name();
+            staleness_status.message     = "OK";
+
+            size_t stale_output_count = 0;
+            for (auto& entry : staleness_monitor_->entries()) {
+                auto stale_tick_count = entry.stale_tick_count.load(std::memory_order::relaxed);
+                auto window_max_age =
+                    entry.window_max_age.exchange(0, std::memory_order::relaxed);
+                if (stale_tick_count == entry.reported_stale_tick_count)
+                    continue;
+
+                stale_output_count++;
+                add_value(
+                    staleness_status, entry.name + " stale_ticks",
+                    stale_tick_count - entry.reported_stale_tick_count);
+                add_value(
+                    staleness_status, entry.name + " max_age_ms",
+                    static_cast<double>(window_max_age) / 1e6);
+                entry.reported_stale_tick_count = stale_tick_count;
+            }
+            if (stale_output_count) {
+                staleness_status.level   = DiagnosticStatus::WARN;
+                staleness_status.message = std::to_string(stale_output_count) + " stale output(s)";
+            }
+            message.status.emplace_back(std::move(staleness_status));
+        }
+
+        for (size_t i = 0; i < partitions_.size(); i++) {
+            auto& partition = *partitions_[i];
+            auto partition_status =
+                make_latency_status("partition " + partition.name(), partition.tick_latency());
+            auto missed_deadline_count = partition.missed_deadline_count();
+            auto& last_count           = last_partition_missed_deadline_counts_[i];
+            add_value(partition_status, "missed_deadline_count", missed_deadline_count);
+            if (missed_deadline_count != last_count) {
+                partition_status.level   = DiagnosticStatus::WARN;
+                partition_status.message = std::to_string(missed_deadline_count - last_count)
+                                         + " deadline(s) missed";
+            }
+            last_count = missed_deadline_count;
+            message.status.emplace_back(std::move(partition_status));
+        }
+
+        size_t dropped_value_count = 0;
+        for (const auto& channel : partition_channels_)
+            dropped_value_count += channel->dropped_count();
+        if (dropped_value_count != last_dropped_value_count_) {
+            DiagnosticStatus channel_status;
+            channel_status.level       = DiagnosticStatus::WARN;
+            channel_status.name        = std::string{get_name()} + ": partition channels";
+            channel_status.hardware_id = get_name();
+            channel_status.message     = "Queued values dropped, raise the queue capacity";
+            add_value(
+                channel_status, "dropped_value_count",
+                dropped_value_count - last_dropped_value_count_);
+            last_dropped_value_count_ = dropped_value_count;
+            message.status.emplace_back(std::move(channel_status));
+        }
+
+        publish_callback_diagnostics(message, add_value);
+
+        for (size_t i = 0; i < updating_order_.size(); i++) {
+            message.status.emplace_back(make_latency_status(
+                updating_order_[i]->get_component_name(), update_entries_[i].latency));
+        }
+        for (auto& partition : partitions_) {
+            for (size_t i = 0; i < partition->updating_order().size(); i++) {
+                message.status.emplace_back(make_latency_status(
+                    partition->updating_order()[i]->get_component_name(),
+                    partition->update_entries()[i].latency));
+            }
+        }
+
+        diagnostics_publisher_->publish(message);
+    }
+
+    // Callbacks of the ROS side that ran since the last report, slowest first. Called from a timer,
+    // hence on the spinning thread.
+    template <typename AddValue>
+    void publish_callback_diagnostics(
+        diagnostic_msgs::msg::DiagnosticArray& message, const AddValue& add_value) {
+        using diagnostic_msgs::msg::DiagnosticStatus;
+        constexpr size_t reported_count = 5;
+
+        DiagnosticStatus callback_status;
+        callback_status.level       = DiagnosticStatus::OK;
+        callback_status.name        = std::string{get_name()} + ": ros callbacks";
+        callback_status.hardware_id = get_name();
+        callback_status.message     = "OK";
+
+        auto summaries = std::vector<std::pair<const std::string*, LatencyHistogram::Summary>>{};
+        uint64_t callback_count = 0;
+        for (auto& callback : rcl_executor_.callbacks()) {
+            auto summary = callback.latency.collect();
+            if (summary.count == 0)
+                continue;
+            callback_count += summary.count;
+            summaries.emplace_back(&callback.name, summary);
+        }
+        std::sort(summaries.begin(), summaries.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second.max > rhs.second.max;
+        });
+
+        add_value(callback_status, "count", callback_count);
+        for (size_t i = 0; i < summaries.size(); i++) {
+            const auto& [name, summary] = summaries[i];
+            auto max_us = std::chrono::duration<double, std::micro>(summary.max).count();
+            if (i < reported_count)
+                add_value(callback_status, *name + " max_us", max_us);
+            if (callback_warn_us_ > 0 && max_us > static_cast<double>(callback_warn_us_)) {
+                callback_status.level   = DiagnosticStatus::WARN;
+                callback_status.message = "Slow callback: " + *name;
+            }
+        }
+        message.status.emplace_back(std::move(callback_status));
+    }
+
+    SpinExecutor& rcl_executor_;
 
     std::thread thread_;
 
@@ -179,7 +1483,48 @@ private:
     std::vector<std::shared_ptr<Component>> component_list_;
 
     std::vector<Component*> updating_order_;
-    size_t dependency_recursive_level_ = 0;
+
+    StartupProfile startup_profile_;
+
+    std::unique_ptr<ParallelScheduler> parallel_scheduler_;
+    std::optional<FusedPipeline> fused_pipeline_;
+
+    double update_rate_   = 0;
+    bool simulated_clock_ = false;
+
+    int64_t realtime_priority_ = 0, realtime_cpu_ = -1, realtime_spin_time_us_ = 0;
+    int64_t callback_warn_us_  = 0;
+
+    std::unique_ptr<UpdateEntry[]> update_entries_;
+    size_t tick_ = 0;
+
+    LatencyHistogram tick_latency_, wakeup_jitter_;
+    std::atomic<size_t> missed_deadline_count_ = 0, max_catch_up_backlog_ = 0;
+    size_t last_missed_deadline_count_         = 0;
+
+    std::shared_ptr<ReplayProvider> replay_provider_;
+    double replay_rate_ = 1.0;
+    std::unique_ptr<data_log::Writer> recorder_;
+    std::unique_ptr<StalenessMonitor> staleness_monitor_;
+    std::unique_ptr<BudgetGovernor> budget_governor_;
+    BudgetGovernor::Level last_budget_level_ = BudgetGovernor::Level::NORMAL;
+    size_t last_degrade_count_               = 0;
+    std::unique_ptr<ShmExporter> shm_exporter_;
+    std::unique_ptr<TraceWriter> trace_writer_;
+    std::unique_ptr<rclcpp::ParameterEventHandler> trace_parameter_subscriber_;
+    std::shared_ptr<rclcpp::ParameterCallbackHandle> trace_parameter_callback_;
+    size_t last_dropped_frame_count_ = 0, last_dropped_event_count_ = 0;
+
+    // Channels are declared before the partitions reading them, so that they outlive them.
+    std::vector<std::unique_ptr<PartitionChannel>> partition_channels_;
+    std::vector<PartitionChannel*> incoming_channels_, outgoing_channels_;
+    std::vector<std::unique_ptr<Partition>> partitions_;
+    std::unordered_map<Component*, Partition*> partition_map_;
+    std::vector<size_t> last_partition_missed_deadline_counts_;
+    size_t last_dropped_value_count_ = 0;
+
+    rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_publisher_;
+    rclcpp::TimerBase::SharedPtr diagnostics_timer_;
 };
 
 }; // namespace rmcs_executor
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "update_entry.hpp"
+
+namespace rmcs_executor {
+
+// Replacement for the updating loop, generated by rmcs_core/scripts/generate_fused_pipeline.py for
+// a frozen configuration. It runs the entries in the order baked into it, calling the update() of
+// the components compiled into it directly so that the compiler can inline across them.
+struct FusedPipeline {
+    // Names of the components in the order `update` expects them, checked against the order the
+    // executor resolves.
+    std::vector<std::string> updating_order;
+
+    // Type of each component called directly, or nullptr for those updated through virtual calls.
+    std::vector<const std::type_info*> types;
+
+    void (*update)(UpdateEntry* entries, size_t tick);
+
+    // Whether `update` measures the components, see UpdateEntry::update.
+    bool timed = true;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
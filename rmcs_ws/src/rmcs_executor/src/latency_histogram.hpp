@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace rmcs_executor {
+
+// Log-linear histogram of durations with ~3% resolution, written by a single thread and read from
+// any other thread. Each call to collect() summarizes the samples recorded since the last call.
+class LatencyHistogram {
+public:
+    struct Summary {
+        uint64_t count = 0;
+        std::chrono::nanoseconds p50{0}, p99{0}, max{0};
+    };
+
+    void record(std::chrono::nanoseconds duration) {
+        auto value = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+
+        auto& bucket = buckets_[bucket_index(value)];
+        bucket.store(bucket.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+
+        if (static_cast<int64_t>(value) > window_max_.load(std::memory_order::relaxed))
+            window_max_.store(static_cast<int64_t>(value), std::memory_order::relaxed);
+    }
+
+    Summary collect() {
+        std::array<uint32_t, bucket_count> window;
+        uint64_t count = 0;
+        for (size_t i = 0; i < bucket_count; i++) {
+            auto current  = buckets_[i].load(std::memory_order::relaxed);
+            window[i]     = current - collected_[i];
+            collected_[i] = current;
+            count += window[i];
+        }
+
+        Summary summary;
+        summary.count = count;
+        summary.max =
+            std::chrono::nanoseconds{window_max_.exchange(0, std::memory_order::relaxed)};
+        if (count == 0)
+            return summary;
+
+        summary.p50 = percentile(window, count, 0.50);
+        summary.p99 = percentile(window, count, 0.99);
+        return summary;
+    }
+
+private:
+    static constexpr unsigned int sub_bucket_bits = 5;
+    static constexpr uint64_t sub_bucket_count    = 1 << sub_bucket_bits;
+    static constexpr size_t bucket_count          = sub_bucket_count * 40;
+
+    static constexpr size_t bucket_index(uint64_t value) {
+        auto width    = static_cast<unsigned int>(std::bit_width(value));
+        auto exponent = width > sub_bucket_bits + 1 ? width - (sub_bucket_bits + 1) : 0;
+        auto index    = sub_bucket_count * exponent + (value >> exponent);
+        return std::min<size_t>(index, bucket_count - 1);
+    }
+
+    static constexpr uint64_t bucket_lower_bound(size_t index) {
+        if (index < 2 * sub_bucket_count)
+            return index;
+        auto exponent = index / sub_bucket_count - 1;
+        return (index - sub_bucket_count * exponent) << exponent;
+    }
+
+    static std::chrono::nanoseconds percentile(
+        const std::array<uint32_t, bucket_count>& window, uint64_t count, double ratio) {
+        auto rank       = static_cast<uint64_t>(static_cast<double>(count - 1) * ratio);
+        uint64_t passed = 0;
+        for (size_t i = 0; i < bucket_count; i++) {
+            passed += window[i];
+            if (passed > rank)
+                return std::chrono::nanoseconds{bucket_lower_bound(i)};
+        }
+        return std::chrono::nanoseconds{bucket_lower_bound(bucket_count - 1)};
+    }
+
+    std::array<std::atomic<uint32_t>, bucket_count> buckets_{};
+    std::array<uint32_t, bucket_count> collected_{};
+    std::atomic<int64_t> window_max_ = 0;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
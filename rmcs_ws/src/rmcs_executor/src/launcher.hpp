@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <pluginlib/class_loader.hpp>
+#include <rclcpp/executors.hpp>
+
+#include "executor.hpp"
+#include "fused_pipeline.hpp"
+#include "rmcs_executor/component.hpp"
+#include "spin_executor.hpp"
+
+namespace rmcs_executor {
+
+// Constructs the component of the given plugin name if it is compiled in, or returns nullptr to
+// have it loaded as a plugin.
+using ComponentConstructor = std::function<std::shared_ptr<Component>(const std::string&)>;
+
+// Main function of the executor, shared by the plugin-based executable and fused pipelines.
+inline int run(
+    int argc, char** argv, const ComponentConstructor& construct = nullptr,
+    std::optional<FusedPipeline> fused_pipeline = std::nullopt) {
+    auto startup_begin = std::chrono::steady_clock::now();
+    rclcpp::init(argc, argv);
+
+    pluginlib::ClassLoader<Component> component_loader("rmcs_executor", "rmcs_executor::Component");
+
+    SpinExecutor rcl_executor;
+    auto executor = std::make_shared<Executor>("rmcs_executor", rcl_executor);
+    rcl_executor.add_node(executor);
+    if (fused_pipeline)
+        executor->set_fused_pipeline(std::move(*fused_pipeline));
+
+    auto& startup_profile = executor->startup_profile();
+    startup_profile.begin_at(startup_begin);
+    startup_profile.mark("rclcpp init and plugin index");
+
+    std::vector<std::string> component_descriptions;
+    if (!executor->get_parameter("components", component_descriptions))
+        throw std::runtime_error("para");
+
+    std::regex regex(R"(\s*(\S+)\s*->\s*(\S+)\s*)");
+    for (const auto& component_description : component_descriptions) {
+        std::smatch matches;
+        std::string plugin_name, component_name;
+
+        if (std::regex_search(component_description, matches, regex)) {
+            if (matches.size() != 3)
+                throw std::runtime_error("In regex matching: unexpected number of matches");
+
+            plugin_name    = matches[1].str();
+            component_name = matches[2].str();
+        } else {
+            plugin_name = component_name = component_description;
+        }
+
+        auto load_begin = std::chrono::steady_clock::now();
+        Component::initializing_component_name = component_name.c_str();
+        auto component = construct ? construct(plugin_name) : nullptr;
+        if (!component)
+            component = component_loader.createSharedInstance(plugin_name);
+        executor->add_component(component);
+        startup_profile.add_component_load(
+            component_name, std::chrono::steady_clock::now() - load_begin);
+    }
+    startup_profile.mark("loading components");
+
+    executor->start();
+    executor->configure_spin_thread();
+    rcl_executor.spin();
+
+    rclcpp::shutdown();
+    return 0;
+}
+
+} // namespace rmcs_executor
\ No newline at end of file
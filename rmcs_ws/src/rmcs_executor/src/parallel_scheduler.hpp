@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+
+#include "realtime.hpp"
+#include "update_entry.hpp"
+
+namespace rmcs_executor {
+
+// Runs the component dependency graph on a fixed pool of worker threads. The thread calling
+// update() also takes part in the work, so `worker_count` only counts the extra threads.
+class ParallelScheduler {
+public:
+    struct Node {
+        UpdateEntry* entry;
+        std::vector<size_t> successors;
+        size_t predecessor_count = 0;
+    };
+
+    // Worker threads are pinned to `cpus` in order, and run with SCHED_FIFO when `fifo_priority` is
+    // positive. Like the control thread, a worker that cannot be pinned or prioritized only logs an
+    // error and keeps running.
+    ParallelScheduler(
+        std::vector<Node> nodes, size_t worker_count, const std::vector<int>& cpus,
+        int fifo_priority, const rclcpp::Logger& logger)
+        : nodes_(std::move(nodes))
+        , pending_(std::make_unique<Counter[]>(nodes_.size()))
+        , ready_queue_(std::make_unique<std::atomic<size_t>[]>(nodes_.size())) {
+
+        for (size_t i = 0; i < worker_count; i++) {
+            auto& worker = workers_.emplace_back([this, i]() {
+                trace::set_thread_name("worker " + std::to_string(i));
+                worker_main();
+            });
+            if (i < cpus.size() && !realtime::set_thread_affinity(worker.native_handle(), cpus[i]))
+                RCLCPP_ERROR(logger, "Unable to pin worker %zu to cpu %d", i, cpus[i]);
+            if (fifo_priority > 0
+                && !realtime::set_thread_fifo_priority(worker.native_handle(), fifo_priority))
+                RCLCPP_ERROR(logger, "Unable to set SCHED_FIFO priority of worker %zu", i);
+        }
+    }
+
+    ParallelScheduler(const ParallelScheduler&)            = delete;
+    ParallelScheduler& operator=(const ParallelScheduler&) = delete;
+    ParallelScheduler(ParallelScheduler&&)                 = delete;
+    ParallelScheduler& operator=(ParallelScheduler&&)      = delete;
+
+    ~ParallelScheduler() {
+        stopping_.store(true, std::memory_order::relaxed);
+        generation_.fetch_add(1, std::memory_order::release);
+        generation_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    void update(size_t tick) {
+        // Workers that woke up late may still be looking at the previous tick.
+        for (size_t spins = 0; active_workers_.load(std::memory_order::acquire) != 0;)
+            back_off(spins);
+
+        for (size_t i = 0; i < nodes_.size(); i++) {
+            pending_[i].value.store(nodes_[i].predecessor_count, std::memory_order::relaxed);
+            ready_queue_[i].store(empty_slot, std::memory_order::relaxed);
+        }
+        tick_ = tick;
+        queue_head_.store(0, std::memory_order::relaxed);
+        queue_tail_.store(0, std::memory_order::relaxed);
+        completed_.store(0, std::memory_order::relaxed);
+
+        for (size_t i = 0; i < nodes_.size(); i++) {
+            if (nodes_[i].predecessor_count == 0)
+                push_ready(i);
+        }
+
+        active_workers_.store(workers_.size(), std::memory_order::relaxed);
+        generation_.fetch_add(1, std::memory_order::release);
+        generation_.notify_all();
+
+        run_until_completed();
+    }
+
+private:
+    static constexpr size_t empty_slot = static_cast<size_t>(-1);
+
+    // Spin first, then give the core away in case there are more threads than free cores.
+    static void back_off(size_t& spins) {
+        if (++spins < 256)
+            realtime::cpu_relax();
+        else
+            std::this_thread::yield();
+    }
+
+    void worker_main() {
+        // Workers are created before the first tick, which bumps the generation from zero.
+        size_t generation = 0;
+        while (true) {
+            // Spin shortly before falling asleep: the next tick usually starts within a period.
+            for (int i = 0; i < 1024 && generation_.load(std::memory_order::acquire) == generation;
+                 i++)
+                realtime::cpu_relax();
+            generation_.wait(generation, std::memory_order::acquire);
+            generation = generation_.load(std::memory_order::acquire);
+
+            if (stopping_.load(std::memory_order::relaxed))
+                return;
+
+            run_until_completed();
+            active_workers_.fetch_sub(1, std::memory_order::release);
+        }
+    }
+
+    void run_until_completed() {
+        const size_t node_count = nodes_.size();
+        size_t spins            = 0;
+        while (completed_.load(std::memory_order::acquire) < node_count) {
+            auto head = queue_head_.load(std::memory_order::relaxed);
+            if (head == queue_tail_.load(std::memory_order::acquire)) {
+                back_off(spins);
+                continue;
+            }
+            if (!queue_head_.compare_exchange_weak(head, head + 1, std::memory_order::acq_rel))
+                continue;
+
+            size_t index;
+            while ((index = ready_queue_[head].load(std::memory_order::acquire)) == empty_slot)
+                back_off(spins);
+
+            spins = 0;
+            execute(index);
+        }
+    }
+
+    void execute(size_t index) {
+        // Entries skipped on this tick still release their successors.
+        auto& node = nodes_[index];
+        node.entry->update(tick_);
+
+        for (auto successor : node.successors) {
+            if (pending_[successor].value.fetch_sub(1, std::memory_order::acq_rel) == 1)
+                push_ready(successor);
+        }
+        completed_.fetch_add(1, std::memory_order::release);
+    }
+
+    void push_ready(size_t index) {
+        auto position = queue_tail_.fetch_add(1, std::memory_order::acq_rel);
+        ready_queue_[position].store(index, std::memory_order::release);
+    }
+
+    struct alignas(64) Counter {
+        std::atomic<size_t> value;
+    };
+
+    std::vector<Node> nodes_;
+    std::unique_ptr<Counter[]> pending_;
+    size_t tick_ = 0;
+
+    // Every node is pushed exactly once per tick, so a flat array indexed by a monotonic tail
+    // is enough for a ready queue.
+    std::unique_ptr<std::atomic<size_t>[]> ready_queue_;
+    alignas(64) std::atomic<size_t> queue_head_ = 0;
+    alignas(64) std::atomic<size_t> queue_tail_ = 0;
+    alignas(64) std::atomic<size_t> completed_  = 0;
+
+    alignas(64) std::atomic<size_t> generation_     = 0;
+    alignas(64) std::atomic<size_t> active_workers_ = 0;
+    std::atomic<bool> stopping_                     = false;
+
+    std::vector<std::thread> workers_;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
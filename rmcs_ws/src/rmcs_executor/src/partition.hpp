@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+
+#include "latency_histogram.hpp"
+#include "partition_channel.hpp"
+#include "predefined_msg_provider.hpp"
+#include "realtime.hpp"
+#include "rmcs_executor/component.hpp"
+#include "rmcs_executor/trace.hpp"
+#include "update_entry.hpp"
+
+namespace rmcs_executor {
+
+// A group of components updated serially on a control thread of its own, at its own rate, next
+// to the main control loop of the executor. Its components see their own `/predefined/*` outputs,
+// and exchange everything else with other partitions through PartitionChannels.
+class Partition {
+public:
+    struct Config {
+        double update_rate;
+        int cpu           = -1;
+        int fifo_priority = 0;
+        std::chrono::nanoseconds spin_time{0};
+    };
+
+    Partition(std::string name, const Config& config, const rclcpp::Logger& logger)
+        : name_(std::move(name))
+        , config_(config)
+        , logger_(logger) {
+        auto provider_name = "predefined_msg_provider@" + name_;
+        Component::initializing_component_name = provider_name.c_str();
+        predefined_msg_provider_               = std::make_unique<PredefinedMsgProvider>();
+        predefined_msg_provider_->set_update_rate(config_.update_rate);
+    }
+
+    Partition(const Partition&)            = delete;
+    Partition& operator=(const Partition&) = delete;
+    Partition(Partition&&)                 = delete;
+    Partition& operator=(Partition&&)      = delete;
+
+    ~Partition() {
+        stopping_.store(true, std::memory_order::relaxed);
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    const std::string& name() const { return name_; }
+    const Config& config() const { return config_; }
+    PredefinedMsgProvider& predefined_msg_provider() { return *predefined_msg_provider_; }
+
+    void add_incoming_channel(PartitionChannel* channel) { incoming_channels_.push_back(channel); }
+    void add_outgoing_channel(PartitionChannel* channel) { outgoing_channels_.push_back(channel); }
+
+    // Entries are filled by the executor before start().
+    void set_updating_order(std::vector<Component*> updating_order) {
+        updating_order_ = std::move(updating_order);
+        update_entries_ = std::make_unique<UpdateEntry[]>(updating_order_.size());
+        for (size_t i = 0; i < updating_order_.size(); i++)
+            update_entries_[i].component = updating_order_[i];
+    }
+    const std::vector<Component*>& updating_order() const { return updating_order_; }
+    UpdateEntry* update_entries() { return update_entries_.get(); }
+
+    // Like the control thread, a partition that cannot be pinned or prioritized only logs an error
+    // and keeps running.
+    void start() {
+        thread_ = std::thread{[this]() {
+            trace::set_thread_name("partition " + name_);
+            realtime::prefault_stack();
+            run();
+        }};
+        if (config_.cpu >= 0
+            && !realtime::set_thread_affinity(thread_.native_handle(), config_.cpu))
+            RCLCPP_ERROR(
+                logger_, "Unable to pin partition %s to cpu %d", name_.c_str(), config_.cpu);
+        if (config_.fifo_priority > 0
+            && !realtime::set_thread_fifo_priority(thread_.native_handle(), config_.fifo_priority))
+            RCLCPP_ERROR(
+                logger_, "Unable to set SCHED_FIFO priority of partition %s", name_.c_str());
+    }
+
+    LatencyHistogram& tick_latency() { return tick_latency_; }
+    size_t missed_deadline_count() const {
+        return missed_deadline_count_.load(std::memory_order::relaxed);
+    }
+
+private:
+    void run() {
+        using namespace std::chrono_literals;
+        const auto period = std::chrono::nanoseconds(
+            static_cast<long>(std::round(1'000'000'000.0 / config_.update_rate)));
+
+        size_t tick              = 0;
+        auto next_iteration_time = std::chrono::steady_clock::now();
+        while (!stopping_.load(std::memory_order::relaxed)) {
+            auto tick_begin    = std::chrono::steady_clock::now();
+            auto wakeup_jitter = tick_begin - next_iteration_time;
+
+            predefined_msg_provider_->set_timestamp(next_iteration_time);
+            next_iteration_time += period;
+            for (auto channel : incoming_channels_)
+                channel->receive();
+            predefined_msg_provider_->update();
+            for (size_t i = 0; i < updating_order_.size(); i++)
+                update_entries_[i].update(tick);
+            for (auto channel : outgoing_channels_)
+                channel->publish();
+            tick++;
+
+            auto tick_end      = std::chrono::steady_clock::now();
+            auto tick_duration = tick_end - tick_begin;
+            tick_latency_.record(tick_duration);
+            if (trace::enabled()) [[unlikely]]
+                trace::record(
+                    "tick", "partition", tick_begin.time_since_epoch().count(),
+                    tick_end.time_since_epoch().count());
+
+            size_t catch_up_backlog = 0;
+            if (tick_end > next_iteration_time) {
+                missed_deadline_count_.fetch_add(1, std::memory_order::relaxed);
+                catch_up_backlog = (tick_end - next_iteration_time + period - 1ns) / period;
+            }
+            predefined_msg_provider_->set_tick_statistics(
+                tick_duration, wakeup_jitter,
+                missed_deadline_count_.load(std::memory_order::relaxed), catch_up_backlog);
+
+            realtime::hybrid_sleep_until(next_iteration_time, config_.spin_time);
+        }
+    }
+
+    std::string name_;
+    Config config_;
+    rclcpp::Logger logger_;
+    std::unique_ptr<PredefinedMsgProvider> predefined_msg_provider_;
+
+    std::vector<Component*> updating_order_;
+    std::unique_ptr<UpdateEntry[]> update_entries_;
+    std::vector<PartitionChannel*> incoming_channels_, outgoing_channels_;
+
+    LatencyHistogram tick_latency_;
+    std::atomic<size_t> missed_deadline_count_ = 0;
+
+    std::atomic<bool> stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include "rmcs_executor/component.hpp"
+
+namespace rmcs_executor {
+
+// Carries an output to the inputs of another partition. The producing partition publishes the value
+// after each of its ticks, the consuming partition receives it into its own copy before each of its
+// ticks, and neither ever waits for the other.
+//
+// A latest-value channel is a triple buffer: the consumer always sees the most recent value. A
+// queued channel hands over every published value in order, one per tick of the consumer, and
+// drops values while it is full.
+class PartitionChannel {
+public:
+    // Copy operations of the value type. Trivially copyable values leave them null and are copied
+    // with memcpy. Other types (e.g. fixed-size Eigen types) should not allocate when copied, as
+    // copies happen on the control threads.
+    struct Copy {
+        void (*construct)(void* destination, const void* source) = nullptr;
+        void (*assign)(void* destination, const void* source)    = nullptr;
+        void (*destroy)(void* value)                              = nullptr;
+    };
+
+    // `capacity` is zero for a latest-value channel, or a power of two for a queued one.
+    PartitionChannel(
+        const void* source, const Component::OutputMetadata* source_metadata, size_t size,
+        size_t alignment, size_t capacity, const Copy& copy)
+        : source_(source)
+        , source_metadata_(source_metadata)
+        , size_(size)
+        , capacity_(capacity)
+        , value_offset_(align_up(sizeof(SlotHeader), alignment))
+        , stride_(align_up(value_offset_ + size, cache_line_size))
+        , copy_(copy)
+        , slots_(allocate(stride_ * slot_count()))
+        , value_(allocate(align_up(size, cache_line_size))) {
+        if (alignment > cache_line_size)
+            throw std::runtime_error{"Alignment of output too large for a partition channel"};
+        if (capacity && !std::has_single_bit(capacity))
+            throw std::runtime_error{"Capacity of a queued channel must be a power of two"};
+
+        // Consumers see the initial value until the first tick of the producer. Slots of values
+        // that are not trivially copyable hold constructed values from the start, and are only
+        // assigned to afterwards.
+        if (copy_.construct) {
+            for (size_t i = 0; i < slot_count(); i++)
+                copy_.construct(slots_.get() + i * stride_ + value_offset_, source_);
+            copy_.construct(value_.get(), source_);
+        } else {
+            std::memcpy(value_.get(), source_, size_);
+        }
+        metadata_.timestamp = source_metadata_->timestamp;
+        metadata_.sequence  = source_metadata_->sequence;
+    }
+
+    PartitionChannel(const PartitionChannel&)            = delete;
+    PartitionChannel& operator=(const PartitionChannel&) = delete;
+    PartitionChannel(PartitionChannel&&)                 = delete;
+    PartitionChannel& operator=(PartitionChannel&&)      = delete;
+
+    ~PartitionChannel() {
+        if (!copy_.destroy)
+            return;
+        for (size_t i = 0; i < slot_count(); i++)
+            copy_.destroy(slots_.get() + i * stride_ + value_offset_);
+        copy_.destroy(value_.get());
+    }
+
+    // Called by the producing partition after its tick. Values not written since the last call
+    // are not published again.
+    void publish() {
+        auto version = source_metadata_->version + source_metadata_->sequence;
+        if (version == published_version_)
+            return;
+        published_version_ = version;
+
+        if (!capacity_) {
+            write_slot(back_);
+            back_ = middle_.exchange(back_ | dirty_bit, std::memory_order::acq_rel) & index_mask;
+            return;
+        }
+
+        auto tail = tail_.load(std::memory_order::relaxed);
+        if (tail - cached_head_ == capacity_) {
+            cached_head_ = head_.load(std::memory_order::acquire);
+            if (tail - cached_head_ == capacity_) {
+                dropped_count_.fetch_add(1, std::memory_order::relaxed);
+                return;
+            }
+        }
+        write_slot(tail & (capacity_ - 1));
+        tail_.store(tail + 1, std::memory_order::release);
+    }
+
+    // Called by the consuming partition before its tick.
+    void receive() {
+        if (!capacity_) {
+            if (!(middle_.load(std::memory_order::relaxed) & dirty_bit))
+                return;
+            front_ = middle_.exchange(front_, std::memory_order::acq_rel) & index_mask;
+            read_slot(front_);
+            return;
+        }
+
+        auto head = head_.load(std::memory_order::relaxed);
+        if (head == tail_.load(std::memory_order::acquire))
+            return;
+        read_slot(head & (capacity_ - 1));
+        head_.store(head + 1, std::memory_order::release);
+    }
+
+    // What the inputs of the consuming partition are bound to.
+    void* value() { return value_.get(); }
+    const Component::OutputMetadata* metadata() const { return &metadata_; }
+
+    bool queued() const { return capacity_ != 0; }
+    size_t dropped_count() const { return dropped_count_.load(std::memory_order::relaxed); }
+
+private:
+    static constexpr size_t cache_line_size = 64;
+    static constexpr uint8_t index_mask = 0b011, dirty_bit = 0b100;
+
+    struct SlotHeader {
+        std::chrono::steady_clock::time_point timestamp;
+        size_t sequence;
+    };
+
+    static constexpr size_t align_up(size_t offset, size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    size_t slot_count() const { return capacity_ ? capacity_ : 3; }
+
+    void copy_value(void* destination, const void* source) const {
+        if (copy_.assign)
+            copy_.assign(destination, source);
+        else
+            std::memcpy(destination, source, size_);
+    }
+
+    struct AlignedDeleter {
+        void operator()(std::byte* pointer) const {
+            ::operator delete(pointer, std::align_val_t{cache_line_size});
+        }
+    };
+    using Buffer = std::unique_ptr<std::byte[], AlignedDeleter>;
+
+    static Buffer allocate(size_t size) {
+        return Buffer{
+            static_cast<std::byte*>(::operator new(size, std::align_val_t{cache_line_size}))};
+    }
+
+    void write_slot(size_t index) {
+        auto slot   = slots_.get() + index * stride_;
+        auto header = SlotHeader{source_metadata_->timestamp, source_metadata_->sequence};
+        std::memcpy(slot, &header, sizeof(header));
+        copy_value(slot + value_offset_, source_);
+    }
+
+    void read_slot(size_t index) {
+        auto slot = slots_.get() + index * stride_;
+        SlotHeader header;
+        std::memcpy(&header, slot, sizeof(header));
+        copy_value(value_.get(), slot + value_offset_);
+        metadata_.timestamp = header.timestamp;
+        metadata_.sequence  = header.sequence;
+        metadata_.version++;
+    }
+
+    // Producer side
+    const void* source_;
+    const Component::OutputMetadata* source_metadata_;
+    size_t size_, capacity_, value_offset_, stride_;
+    Copy copy_;
+    size_t published_version_ = static_cast<size_t>(-1);
+
+    Buffer slots_;
+
+    // Latest-value channel: the producer owns `back_`, the consumer `front_`, and they swap their
+    // buffer with `middle_`, marked dirty when it holds an unread value.
+    alignas(cache_line_size) std::atomic<uint8_t> middle_ = 1;
+    alignas(cache_line_size) uint8_t back_                = 2;
+    size_t cached_head_                                   = 0;
+    std::atomic<size_t> dropped_count_                    = 0;
+    alignas(cache_line_size) uint8_t front_               = 0;
+
+    // Queued channel: both indices only grow, their difference is the number of queued values.
+    alignas(cache_line_size) std::atomic<size_t> tail_ = 0;
+    alignas(cache_line_size) std::atomic<size_t> head_ = 0;
+
+    // Consumer side
+    alignas(cache_line_size) Component::OutputMetadata metadata_;
+    Buffer value_;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
@@ -9,15 +9,36 @@ public:
         register_output("/predefined/update_rate", update_rate_);
         register_output("/predefined/update_count", update_count_, static_cast<size_t>(-1));
         register_output("/predefined/timestamp", timestamp_);
+
+        register_output("/predefined/tick_duration", tick_duration_, 0.0);
+        register_output("/predefined/wakeup_jitter", wakeup_jitter_, 0.0);
+        register_output("/predefined/missed_deadline_count", missed_deadline_count_, size_t{0});
+        register_output("/predefined/catch_up_backlog", catch_up_backlog_, size_t{0});
     }
 
     void set_update_rate(double frame_rate) { *update_rate_ = frame_rate; }
     void set_timestamp(std::chrono::steady_clock::time_point timestamp) { *timestamp_ = timestamp; }
 
+    // Statistics of the previous tick, visible to components during the current tick.
+    void set_tick_statistics(
+        std::chrono::steady_clock::duration tick_duration,
+        std::chrono::steady_clock::duration wakeup_jitter, size_t missed_deadline_count,
+        size_t catch_up_backlog) {
+        *tick_duration_         = std::chrono::duration<double>(tick_duration).count();
+        *wakeup_jitter_         = std::chrono::duration<double>(wakeup_jitter).count();
+        *missed_deadline_count_ = missed_deadline_count;
+        *catch_up_backlog_      = catch_up_backlog;
+    }
+
     void update() override { *update_count_ += 1; }
 
 private:
     OutputInterface<double> update_rate_;
     OutputInterface<size_t> update_count_;
     OutputInterface<std::chrono::steady_clock::time_point> timestamp_;
+
+    OutputInterface<double> tick_duration_;
+    OutputInterface<double> wakeup_jitter_;
+    OutputInterface<size_t> missed_deadline_count_;
+    OutputInterface<size_t> catch_up_backlog_;
 };
\ No newline at end of file
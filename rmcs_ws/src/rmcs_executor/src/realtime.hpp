@@ -0,0 +1,91 @@
+#pragma once
+
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace rmcs_executor::realtime {
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+inline bool set_thread_affinity(pthread_t thread, int cpu) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set) == 0;
+}
+
+inline bool set_thread_affinity(pthread_t thread, const std::vector<int>& cpus) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (auto cpu : cpus)
+        CPU_SET(cpu, &cpu_set);
+    return pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set) == 0;
+}
+
+// Nice value of the calling thread only, under the default scheduling policy.
+inline bool set_this_thread_nice(int nice) {
+    return setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), nice) == 0;
+}
+
+inline bool set_thread_fifo_priority(pthread_t thread, int priority) {
+    sched_param param{};
+    param.sched_priority = priority;
+    return pthread_setschedparam(thread, SCHED_FIFO, &param) == 0;
+}
+
+// Locks current and future pages in RAM and keeps glibc from returning freed memory to the kernel,
+// so that no page fault happens in the control loop after warming up.
+inline bool lock_memory(size_t heap_prefault_size) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        return false;
+
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    auto heap = std::make_unique<volatile std::byte[]>(heap_prefault_size);
+    for (size_t i = 0; i < heap_prefault_size; i += 4096)
+        heap[i] = std::byte{0};
+    return true;
+}
+
+// Must be called from the thread whose stack should be faulted in.
+inline void prefault_stack() {
+    constexpr size_t stack_prefault_size = 256 * 1024;
+    volatile std::byte stack[stack_prefault_size];
+    for (size_t i = 0; i < stack_prefault_size; i += 4096)
+        stack[i] = std::byte{0};
+    static_cast<void>(stack[0]);
+}
+
+// Sleeps until `spin_time` before the deadline, then busy-waits the rest to avoid the wakeup
+// latency of the scheduler.
+inline void hybrid_sleep_until(
+    std::chrono::steady_clock::time_point deadline, std::chrono::nanoseconds spin_time) {
+    if (spin_time <= std::chrono::nanoseconds::zero()) {
+        std::this_thread::sleep_until(deadline);
+        return;
+    }
+
+    std::this_thread::sleep_until(deadline - spin_time);
+    while (std::chrono::steady_clock::now() < deadline)
+        cpu_relax();
+}
+
+} // namespace rmcs_executor::realtime
\ No newline at end of file
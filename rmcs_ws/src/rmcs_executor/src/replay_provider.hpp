@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "data_log.hpp"
+#include "rmcs_executor/component.hpp"
+
+namespace rmcs_executor {
+
+// Produces the outputs recorded in a data log. Its outputs are declared by the executor, which
+// resolves their types from the inputs consuming them.
+class ReplayProvider : public Component {
+public:
+    explicit ReplayProvider(const std::string& path)
+        : reader_(std::make_unique<data_log::Reader>(path)) {}
+
+    const std::vector<data_log::Channel>& channels() const { return reader_->channels(); }
+    size_t frame_count() const { return reader_->frame_count(); }
+
+    struct ReplayedChannel {
+        const data_log::Channel* channel;
+        std::unique_ptr<std::max_align_t[]> storage;
+        OutputMetadata metadata;
+    };
+
+    const ReplayedChannel& add_channel(const data_log::Channel& channel) {
+        auto& replayed   = replayed_channels_.emplace_back();
+        replayed.channel = &channel;
+        replayed.storage = std::make_unique<std::max_align_t[]>(
+            (channel.size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+        return replayed;
+    }
+
+    // Called by the executor before each tick. Returns the recorded timestamp of the frame, or
+    // nothing when the log is exhausted.
+    std::optional<std::chrono::steady_clock::time_point> next_frame() {
+        if (frame_index_ == reader_->frame_count())
+            return std::nullopt;
+
+        for (const auto& replayed : replayed_channels_) {
+            std::memcpy(
+                replayed.storage.get(), reader_->channel_data(frame_index_, *replayed.channel),
+                replayed.channel->size);
+        }
+
+        auto header    = reader_->frame_header(frame_index_++);
+        auto timestamp = std::chrono::steady_clock::time_point{
+            std::chrono::nanoseconds{header.timestamp}};
+        for (auto& replayed : replayed_channels_) {
+            replayed.metadata.version++;
+            replayed.metadata.sequence++;
+            replayed.metadata.timestamp = timestamp;
+        }
+        return timestamp;
+    }
+
+    void update() override {}
+
+private:
+    std::unique_ptr<data_log::Reader> reader_;
+    // Outputs point into the channels, which must not move.
+    std::deque<ReplayedChannel> replayed_channels_;
+    size_t frame_index_ = 0;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
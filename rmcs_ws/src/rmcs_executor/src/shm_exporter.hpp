@@ -0,0 +1,128 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rmcs_executor/shm_layout.hpp"
+
+namespace rmcs_executor {
+
+// Mirrors outputs into a POSIX shared-memory segment once per tick, for rmcs_executor::shm::Client.
+// The control thread only ever copies: readers retry instead of blocking it.
+class ShmExporter {
+public:
+    struct Source {
+        std::string name;
+        std::string type;
+        size_t size;
+        const void* data;
+    };
+
+    ShmExporter(const std::string& name, const std::vector<Source>& sources)
+        : name_(name) {
+        auto data_offset = shm::padded_size(
+            sizeof(shm::Header) + sources.size() * sizeof(shm::Channel));
+        auto data_size = sizeof(shm::FrameHeader);
+        for (const auto& source : sources) {
+            if (source.name.size() >= sizeof(shm::Channel::name)
+                || source.type.size() >= sizeof(shm::Channel::type))
+                throw std::runtime_error{"Name or type too long to export: " + source.name};
+            channels_.push_back({source.data, data_size / 8, source.size});
+            data_size += shm::padded_size(source.size);
+        }
+        size_ = data_offset + data_size;
+
+        shm_unlink(name_.c_str());
+        fd_ = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd_ < 0)
+            throw std::runtime_error{"Unable to create shared memory " + name_};
+        if (ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+            close_segment();
+            throw std::runtime_error{"Unable to resize shared memory " + name_};
+        }
+        auto pointer = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (pointer == MAP_FAILED) {
+            close_segment();
+            throw std::runtime_error{"Unable to map shared memory " + name_};
+        }
+        base_ = static_cast<std::byte*>(pointer);
+
+        auto& header = *::new (base_) shm::Header{};
+        std::memcpy(header.magic, shm::magic, sizeof(shm::magic));
+        header.version       = shm::version;
+        header.channel_count = static_cast<uint32_t>(sources.size());
+        header.data_offset   = data_offset;
+        header.data_size     = data_size;
+
+        auto channel_table = reinterpret_cast<shm::Channel*>(base_ + sizeof(shm::Header));
+        for (size_t i = 0; i < sources.size(); i++) {
+            auto& channel = *::new (&channel_table[i]) shm::Channel{};
+            std::strcpy(channel.name, sources[i].name.c_str());
+            std::strcpy(channel.type, sources[i].type.c_str());
+            channel.offset = channels_[i].word_offset * 8;
+            channel.size   = sources[i].size;
+        }
+
+        header_ = &header;
+        data_   = reinterpret_cast<uint64_t*>(base_ + data_offset);
+    }
+
+    ShmExporter(const ShmExporter&)            = delete;
+    ShmExporter& operator=(const ShmExporter&) = delete;
+    ShmExporter(ShmExporter&&)                 = delete;
+    ShmExporter& operator=(ShmExporter&&)      = delete;
+
+    ~ShmExporter() {
+        header_->closed.store(1, std::memory_order::relaxed);
+        munmap(base_, size_);
+        close_segment();
+    }
+
+    // Called by the control thread after the components are updated.
+    void publish(uint64_t tick, std::chrono::steady_clock::time_point timestamp) {
+        auto sequence = header_->sequence.load(std::memory_order::relaxed);
+        header_->sequence.store(sequence + 1, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::release);
+
+        shm::FrameHeader frame_header{tick, timestamp.time_since_epoch().count()};
+        shm::store_words(data_, &frame_header, sizeof(frame_header));
+        for (const auto& channel : channels_)
+            shm::store_words(data_ + channel.word_offset, channel.source, channel.size);
+
+        header_->sequence.store(sequence + 2, std::memory_order::release);
+    }
+
+    size_t channel_count() const { return channels_.size(); }
+
+private:
+    void close_segment() {
+        ::close(fd_);
+        shm_unlink(name_.c_str());
+    }
+
+    struct ExportedChannel {
+        const void* source;
+        size_t word_offset;
+        size_t size;
+    };
+
+    std::string name_;
+    std::vector<ExportedChannel> channels_;
+
+    int fd_;
+    size_t size_;
+    std::byte* base_;
+    shm::Header* header_;
+    uint64_t* data_;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <rclcpp/any_executable.hpp>
+#include <rclcpp/executors/single_threaded_executor.hpp>
+#include <rcpputils/scope_exit.hpp>
+
+#include "latency_histogram.hpp"
+#include "rmcs_executor/trace.hpp"
+
+namespace rmcs_executor {
+
+// Runs the ROS side of every component (subscriptions, timers, services, parameter events) on the
+// thread calling spin(), like the SingleThreadedExecutor it derives from, and times every callback
+// it executes. Callbacks touching the state of a component should go through Component::defer.
+class SpinExecutor : public rclcpp::executors::SingleThreadedExecutor {
+public:
+    struct Callback {
+        std::string name;
+        LatencyHistogram latency;
+    };
+
+    void spin() override {
+        if (spinning.exchange(true))
+            throw std::runtime_error{"spin() called while already spinning"};
+        RCPPUTILS_SCOPE_EXIT(this->spinning.store(false));
+
+        while (rclcpp::ok(context_) && spinning.load()) {
+            rclcpp::AnyExecutable any_executable;
+            if (!get_next_executable(any_executable))
+                continue;
+
+            auto begin = std::chrono::steady_clock::now();
+            execute_any_executable(any_executable);
+            auto end = std::chrono::steady_clock::now();
+
+            auto& callback = find_callback(any_executable);
+            callback.latency.record(end - begin);
+            if (trace::enabled()) [[unlikely]]
+                trace::record(
+                    callback.name.c_str(), "ros", begin.time_since_epoch().count(),
+                    end.time_since_epoch().count());
+        }
+    }
+
+    // Only to be read from the spinning thread, e.g. by a timer callback.
+    std::deque<Callback>& callbacks() { return callbacks_; }
+
+private:
+    Callback& find_callback(const rclcpp::AnyExecutable& any_executable) {
+        const void* key = any_executable.waitable.get();
+        if (any_executable.subscription)
+            key = any_executable.subscription.get();
+        else if (any_executable.timer)
+            key = any_executable.timer.get();
+        else if (any_executable.service)
+            key = any_executable.service.get();
+        else if (any_executable.client)
+            key = any_executable.client.get();
+        auto [iter, inserted] = callback_index_map_.try_emplace(key, callbacks_.size());
+        if (!inserted)
+            return callbacks_[iter->second];
+
+        std::string name;
+        if (any_executable.node_base)
+            name = std::string{any_executable.node_base->get_name()} + ": ";
+        if (any_executable.subscription)
+            name += std::string{"subscription "} + any_executable.subscription->get_topic_name();
+        else if (any_executable.timer)
+            name += "timer";
+        else if (any_executable.service)
+            name += std::string{"service "} + any_executable.service->get_service_name();
+        else if (any_executable.client)
+            name += std::string{"client "} + any_executable.client->get_service_name();
+        else
+            name += "waitable";
+
+        auto& callback = callbacks_.emplace_back();
+        callback.name  = std::move(name);
+        return callback;
+    }
+
+    // Callbacks are never forgotten, so that trace events may keep pointing to their names.
+    std::deque<Callback> callbacks_;
+    std::unordered_map<const void*, size_t> callback_index_map_;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "rmcs_executor/component.hpp"
+
+namespace rmcs_executor {
+
+// Compares the timestamps of stamped outputs against the tick timestamp on the control thread, and
+// keeps what the diagnostics thread needs to report outputs older than their bound.
+class StalenessMonitor {
+public:
+    struct Entry {
+        std::string name;
+        const Component::OutputMetadata* metadata;
+        std::chrono::nanoseconds max_age;
+
+        std::atomic<size_t> stale_tick_count = 0;
+        std::atomic<int64_t> window_max_age  = 0;
+        size_t reported_stale_tick_count     = 0;
+    };
+
+    void add(
+        std::string name, const Component::OutputMetadata* metadata,
+        std::chrono::nanoseconds max_age) {
+        entries_.emplace_back(std::move(name), metadata, max_age);
+    }
+
+    void check(std::chrono::steady_clock::time_point now) {
+        for (auto& entry : entries_) {
+            // Never stamped: the producer does not provide timestamps.
+            if (entry.metadata->sequence == 0)
+                continue;
+
+            auto age = (now - entry.metadata->timestamp).count();
+            if (age > entry.window_max_age.load(std::memory_order::relaxed))
+                entry.window_max_age.store(age, std::memory_order::relaxed);
+            if (age > entry.max_age.count()) {
+                entry.stale_tick_count.store(
+                    entry.stale_tick_count.load(std::memory_order::relaxed) + 1,
+                    std::memory_order::relaxed);
+            }
+        }
+    }
+
+    std::deque<Entry>& entries() { return entries_; }
+
+private:
+    std::deque<Entry> entries_;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
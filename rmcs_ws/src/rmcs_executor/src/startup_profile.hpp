@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rmcs_executor {
+
+// Time spent in each phase from the start of the process to the first tick, reported once the
+// first tick is done.
+class StartupProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Phase {
+        std::string name;
+        Clock::duration duration;
+    };
+
+    void begin_at(Clock::time_point begin) { begin_ = last_ = begin; }
+
+    // Closes the phase that started at the previous mark.
+    void mark(std::string name) {
+        auto now = Clock::now();
+        phases_.emplace_back(std::move(name), now - last_);
+        last_ = now;
+    }
+
+    void add_component_load(std::string component_name, Clock::duration duration) {
+        component_loads_.emplace_back(std::move(component_name), duration);
+    }
+
+    const std::vector<Phase>& phases() const { return phases_; }
+    Clock::duration total() const { return last_ - begin_; }
+
+    std::vector<Phase> slowest_component_loads(size_t count) const {
+        auto loads = component_loads_;
+        std::sort(loads.begin(), loads.end(), [](const Phase& lhs, const Phase& rhs) {
+            return lhs.duration > rhs.duration;
+        });
+        loads.resize(std::min(count, loads.size()));
+        return loads;
+    }
+
+private:
+    Clock::time_point begin_ = Clock::now(), last_ = begin_;
+    std::vector<Phase> phases_;
+    std::vector<Phase> component_loads_;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
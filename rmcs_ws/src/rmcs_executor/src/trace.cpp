@@ -0,0 +1,52 @@
+#include "rmcs_executor/trace.hpp"
+
+#include <mutex>
+
+namespace rmcs_executor::trace {
+
+namespace {
+
+std::mutex buffer_list_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> buffer_list;
+std::atomic<uint64_t> next_thread_id    = 1;
+std::atomic<bool> reserve_named_buffers = false;
+
+thread_local std::string this_thread_name;
+thread_local std::shared_ptr<ThreadBuffer> this_thread_buffer_pointer;
+
+} // namespace
+
+std::atomic<bool> detail::enabled = false;
+
+// Allocated on the first event of the thread, so that threads never traced cost nothing, unless
+// reserved when the thread was named.
+ThreadBuffer& detail::this_thread_buffer() {
+    auto& buffer = this_thread_buffer_pointer;
+    if (!buffer) [[unlikely]] {
+        buffer              = std::make_shared<ThreadBuffer>();
+        buffer->thread_id   = next_thread_id.fetch_add(1, std::memory_order::relaxed);
+        buffer->thread_name = this_thread_name.empty()
+                                ? "thread " + std::to_string(buffer->thread_id)
+                                : this_thread_name;
+        std::lock_guard guard{buffer_list_mutex};
+        buffer_list.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void set_thread_name(std::string name) {
+    this_thread_name = std::move(name);
+    if (reserve_named_buffers.load(std::memory_order::relaxed))
+        detail::this_thread_buffer();
+}
+
+void reserve_named_thread_buffers() {
+    reserve_named_buffers.store(true, std::memory_order::relaxed);
+}
+
+std::vector<std::shared_ptr<ThreadBuffer>> thread_buffers() {
+    std::lock_guard guard{buffer_list_mutex};
+    return buffer_list;
+}
+
+} // namespace rmcs_executor::trace
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+#include "rmcs_executor/trace.hpp"
+
+namespace rmcs_executor {
+
+// Drains the per-thread trace buffers every `flush_period` and appends their events to a file in
+// the Chrome trace event format, which chrome://tracing and ui.perfetto.dev both open. The closing
+// bracket of the array is optional in that format, so the file stays valid even after a crash.
+class TraceWriter {
+public:
+    TraceWriter(const std::string& path, std::chrono::nanoseconds flush_period)
+        : flush_period_(flush_period) {
+        file_ = std::fopen(path.c_str(), "w");
+        if (!file_)
+            throw std::runtime_error{"Unable to open trace file " + path};
+        std::fputs("[\n", file_);
+
+        thread_ = std::thread{[this]() {
+            trace::set_thread_name("trace writer");
+            std::unique_lock lock{mutex_};
+            while (!stopping_) {
+                condition_.wait_for(lock, flush_period_);
+                flush();
+            }
+        }};
+    }
+
+    TraceWriter(const TraceWriter&)            = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+    TraceWriter(TraceWriter&&)                 = delete;
+    TraceWriter& operator=(TraceWriter&&)      = delete;
+
+    ~TraceWriter() {
+        {
+            std::lock_guard guard{mutex_};
+            stopping_ = true;
+        }
+        condition_.notify_all();
+        thread_.join();
+
+        std::fputs("{}]\n", file_);
+        std::fclose(file_);
+    }
+
+    // Events lost because a thread filled its buffer between two flushes.
+    size_t dropped_count() const {
+        size_t dropped_count = 0;
+        for (const auto& buffer : trace::thread_buffers())
+            dropped_count += buffer->dropped_count.load(std::memory_order::relaxed);
+        return dropped_count;
+    }
+
+private:
+    void flush() {
+        for (const auto& buffer : trace::thread_buffers()) {
+            if (named_threads_.insert(buffer->thread_id).second) {
+                std::fprintf(
+                    file_,
+                    R"({"name":"thread_name","ph":"M","pid":1,"tid":%lu,"args":{"name":"%s"}},)"
+                    "\n",
+                    buffer->thread_id, escape(buffer->thread_name).c_str());
+            }
+
+            trace::Event events[256];
+            while (auto count = buffer->events.read(events, std::size(events))) {
+                for (size_t i = 0; i < count; i++) {
+                    const auto& event = events[i];
+                    std::fprintf(
+                        file_,
+                        R"({"name":"%s","cat":"%s","ph":"X","ts":%.3f,"dur":%.3f,)"
+                        R"("pid":1,"tid":%lu},)"
+                        "\n",
+                        escape(event.name).c_str(), event.category,
+                        static_cast<double>(event.begin) / 1e3,
+                        static_cast<double>(event.duration) / 1e3, buffer->thread_id);
+                }
+            }
+        }
+        std::fflush(file_);
+    }
+
+    static std::string escape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\')
+                escaped.push_back('\\');
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+
+    std::FILE* file_;
+    std::chrono::nanoseconds flush_period_;
+    std::unordered_set<uint64_t> named_threads_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
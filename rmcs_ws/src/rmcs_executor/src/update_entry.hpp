@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "latency_histogram.hpp"
+#include "rmcs_executor/component.hpp"
+#include "rmcs_executor/trace.hpp"
+
+namespace rmcs_executor {
+
+// Per-component state of the updating loop, shared by the serial loop and the parallel scheduler.
+struct UpdateEntry {
+    Component* component = nullptr;
+    size_t divisor       = 1;
+    LatencyHistogram latency;
+
+    // Versions of the outputs bound to the inputs of a lazily updated component, and their values
+    // at its last update.
+    bool lazy = false;
+    std::vector<const size_t*> input_versions;
+    std::vector<size_t> last_input_versions;
+
+    // Time budget of a single update(), zero if there is none. Overruns are flagged for the budget
+    // governor, which may in turn skip best-effort components.
+    std::chrono::nanoseconds budget{0};
+    bool overran = false;
+    bool skipped = false;
+
+    template <bool timed = true>
+    void update(size_t tick) {
+        update<timed>(tick, [this]() { component->update(); });
+    }
+
+    // Same as update(tick), with the call to update() provided by the caller, e.g. a direct call
+    // from a fused pipeline. Untimed updates skip the latency, the budget and the trace, for fused
+    // pipelines built without timing.
+    template <bool timed = true, typename F>
+    void update(size_t tick, F&& update_component) {
+        component->run_deferred_callbacks();
+        if (skipped || (lazy && !inputs_changed()) || (divisor != 1 && tick % divisor != 0))
+            return;
+        if (lazy)
+            snapshot_input_versions();
+
+        if constexpr (!timed) {
+            update_component();
+            return;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        update_component();
+        auto end = std::chrono::steady_clock::now();
+        latency.record(end - begin);
+        if (budget.count() != 0 && end - begin > budget) [[unlikely]]
+            overran = true;
+
+        if (trace::enabled()) [[unlikely]]
+            trace::record(
+                component->get_component_name().c_str(), "update",
+                begin.time_since_epoch().count(), end.time_since_epoch().count());
+    }
+
+private:
+    bool inputs_changed() const {
+        for (size_t i = 0; i < input_versions.size(); i++)
+            if (*input_versions[i] != last_input_versions[i])
+                return true;
+        return false;
+    }
+
+    void snapshot_input_versions() {
+        for (size_t i = 0; i < input_versions.size(); i++)
+            last_input_versions[i] = *input_versions[i];
+    }
+};
+
+} // namespace rmcs_executor
\ No newline at end of file
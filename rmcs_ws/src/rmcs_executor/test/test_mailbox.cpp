@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "rmcs_executor/mailbox.hpp"
+
+namespace rmcs_executor::mailbox {
+
+class AggregatorTest : public testing::Test {
+protected:
+    using Aggregator = mailbox::Aggregator<1>;
+
+    // Same as Aggregator::read(), with `between` run after the snapshot and before the
+    // acknowledgement.
+    template <typename F>
+    static SampleSummary read_around(Aggregator& aggregator, F&& between) {
+        auto state = aggregator.state_.read();
+        between();
+        return aggregator.summarize(state)[0];
+    }
+};
+
+TEST_F(AggregatorTest, SummarizesSamplesSinceTheLastRead) {
+    Aggregator aggregator;
+    aggregator.write({3.0});
+    aggregator.write({1.0});
+    aggregator.write({2.0});
+
+    auto summary = aggregator.read()[0];
+    EXPECT_EQ(summary.count, 3);
+    EXPECT_EQ(summary.latest, 2.0);
+    EXPECT_EQ(summary.mean, 2.0);
+    EXPECT_EQ(summary.min, 1.0);
+    EXPECT_EQ(summary.max, 3.0);
+
+    summary = aggregator.read()[0];
+    EXPECT_EQ(summary.count, 0);
+    EXPECT_EQ(summary.latest, 2.0);
+    EXPECT_EQ(summary.min, 2.0);
+    EXPECT_EQ(summary.max, 2.0);
+}
+
+TEST_F(AggregatorTest, WriteBetweenReadAndAcknowledgementOnlyCountsOnce) {
+    Aggregator aggregator;
+    aggregator.write({-10.0});
+    aggregator.write({10.0});
+
+    auto first = read_around(aggregator, [&aggregator]() { aggregator.write({1.0}); });
+    EXPECT_EQ(first.count, 2);
+    EXPECT_EQ(first.min, -10.0);
+    EXPECT_EQ(first.max, 10.0);
+
+    auto second = aggregator.read()[0];
+    EXPECT_EQ(second.count, 1);
+    EXPECT_EQ(second.mean, 1.0);
+    EXPECT_EQ(second.min, 1.0);
+    EXPECT_EQ(second.max, 1.0);
+
+    // The producer catches up with the acknowledgement on its next write.
+    aggregator.write({2.0});
+    auto third = aggregator.read()[0];
+    EXPECT_EQ(third.count, 1);
+    EXPECT_EQ(third.min, 2.0);
+    EXPECT_EQ(third.max, 2.0);
+}
+
+TEST_F(AggregatorTest, SeveralWritesBetweenReadAndAcknowledgement) {
+    Aggregator aggregator;
+    aggregator.write({100.0});
+
+    read_around(aggregator, [&aggregator]() {
+        aggregator.write({4.0});
+        aggregator.write({6.0});
+        aggregator.write({5.0});
+    });
+
+    auto summary = aggregator.read()[0];
+    EXPECT_EQ(summary.count, 3);
+    EXPECT_EQ(summary.mean, 5.0);
+    EXPECT_EQ(summary.min, 4.0);
+    EXPECT_EQ(summary.max, 6.0);
+}
+
+} // namespace rmcs_executor::mailbox
@@ -6,6 +6,11 @@
 namespace rmcs_msgs {
 
 struct SerialInterface {
+    // write() fills a buffer that the producer also sends from its own update() (e.g. the transmit
+    // buffer of a board). The producer and every component writing to the serial register this key
+    // with register_shared_state, so that they are never updated concurrently.
+    static constexpr char shared_state[] = "rmcs_msgs::SerialInterface";
+
     std::function<size_t(std::byte*, size_t)> read;
     std::function<size_t(const std::byte*, size_t)> write;    
 };